@@ -20,6 +20,9 @@
 #include <cstring>
 #include <ctime>
 #include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "Profiler.h"
 
@@ -834,6 +837,239 @@ namespace Profiler {
 #endif
 	}*/
 
+	/*
+	============
+	Trace - per thread ring buffers of completed scopes
+
+	Only the owning thread touches its buffer while tracing is enabled. It
+	raises 'busy' around every access and re-checks 'enabled' afterwards, so
+	once tracestop has cleared 'enabled' and seen every buffer idle, the
+	buffers can be read without further locking. Starting a new trace bumps
+	the generation, and each thread resets its own buffer when it notices.
+	============
+	*/
+
+	struct TraceEvent {
+		const char *name; // NULL for a frame marker
+		u64 start, end;
+	};
+
+	struct TraceThread {
+		enum { MaxDepth = 256 };
+
+		TraceThread( u32 id_ ) : id(id_), events(NULL), capacity(0), count(0), depth(0), generation(0), busy(0) { name[0] = 0; }
+		~TraceThread() { free( events ); }
+
+		char name[64];
+		u32 id;
+		TraceEvent *events;
+		u32 capacity; // always a power of two
+		u64 count; // events written in this generation, the ring holds the last 'capacity'
+		u32 depth;
+		u32 generation;
+		TraceEvent stack[MaxDepth];
+		std::atomic<u32> busy;
+	};
+
+	std::atomic<bool> traceEnabled( false );
+
+	struct TraceThreadList {
+		~TraceThreadList() {
+			// job threads can outlive static destruction
+			traceEnabled.store( false );
+			for ( size_t i = 0; i < list.size(); i++ ) {
+				while ( list[i]->busy.load( std::memory_order_acquire ) )
+					YIELD()
+				delete list[i];
+			}
+		}
+
+		std::vector<TraceThread *> list;
+		std::mutex lock;
+	};
+
+	TraceThreadList traceThreads;
+	std::atomic<u32> traceGeneration( 0 );
+	u32 traceCapacity = 0;
+	u64 traceStart = 0;
+	thread_local TraceThread *traceThread = NULL;
+	thread_local const char *traceThreadName = NULL;
+
+	inline TraceThread *getTraceThread() {
+		if ( !traceThread ) {
+			std::lock_guard<std::mutex> lock( traceThreads.lock );
+			traceThread = new TraceThread( u32( traceThreads.list.size() ) + 1 );
+			if ( traceThreadName )
+				snprintf( traceThread->name, sizeof( traceThread->name ), "%s", traceThreadName );
+			else
+				snprintf( traceThread->name, sizeof( traceThread->name ), "Thread %u", traceThread->id );
+			traceThread->name[sizeof( traceThread->name ) - 1] = 0;
+			traceThreads.list.push_back( traceThread );
+		}
+		return traceThread;
+	}
+
+	// must be called with busy raised and tracing enabled
+	inline void syncTraceThread( TraceThread *t ) {
+		const u32 generation = traceGeneration.load( std::memory_order_acquire );
+		if ( t->generation == generation )
+			return;
+
+		t->generation = generation;
+		t->count = 0;
+		t->depth = 0;
+		if ( t->capacity != traceCapacity ) {
+			free( t->events );
+			t->events = (TraceEvent *)malloc( traceCapacity * sizeof( TraceEvent ) );
+			t->capacity = traceCapacity;
+		}
+	}
+
+	inline void traceEnter( const char *name ) {
+		if ( !traceEnabled.load( std::memory_order_relaxed ) )
+			return;
+
+		TraceThread *t = getTraceThread();
+		t->busy.store( 1 );
+		if ( traceEnabled.load() ) {
+			syncTraceThread( t );
+			if ( t->depth < TraceThread::MaxDepth ) {
+				TraceEvent &e = t->stack[t->depth];
+				e.name = name;
+				e.start = Clock::getticks();
+			}
+			t->depth++;
+		}
+		t->busy.store( 0, std::memory_order_release );
+	}
+
+	inline void traceExit() {
+		TraceThread *t = traceThread;
+		if ( !t || !traceEnabled.load( std::memory_order_relaxed ) )
+			return;
+
+		const u64 end = Clock::getticks();
+		t->busy.store( 1 );
+		if ( traceEnabled.load() ) {
+			syncTraceThread( t );
+			// scopes entered before the trace started have nothing on the stack
+			if ( t->depth && --t->depth < TraceThread::MaxDepth ) {
+				TraceEvent &e = t->events[t->count++ & ( t->capacity - 1 )];
+				e = t->stack[t->depth];
+				e.end = end;
+			}
+		}
+		t->busy.store( 0, std::memory_order_release );
+	}
+
+	inline void traceMarkFrame() {
+		if ( !traceEnabled.load( std::memory_order_relaxed ) )
+			return;
+
+		TraceThread *t = getTraceThread();
+		t->busy.store( 1 );
+		if ( traceEnabled.load() ) {
+			syncTraceThread( t );
+			TraceEvent &e = t->events[t->count++ & ( t->capacity - 1 )];
+			e.name = NULL;
+			e.start = e.end = Clock::getticks();
+		}
+		t->busy.store( 0, std::memory_order_release );
+	}
+
+	// caller holds traceThreads.lock
+	void traceDisable() {
+		traceEnabled.store( false );
+		for ( size_t i = 0; i < traceThreads.list.size(); i++ )
+			while ( traceThreads.list[i]->busy.load( std::memory_order_acquire ) )
+				YIELD()
+	}
+
+	void traceBegin( u32 eventsPerThread ) {
+		// register the controlling thread first so it sorts to the top
+		getTraceThread();
+
+		std::lock_guard<std::mutex> lock( traceThreads.lock );
+		traceDisable();
+		traceCapacity = nextpow2( max( eventsPerThread, u32(2) ) - 1 );
+		traceStart = Clock::getticks();
+		traceGeneration.fetch_add( 1, std::memory_order_release );
+		traceEnabled.store( true );
+	}
+
+	void traceEnd() {
+		std::lock_guard<std::mutex> lock( traceThreads.lock );
+		traceDisable();
+	}
+
+	void traceSetThreadName( const char *name ) {
+		traceThreadName = name;
+		if ( traceThread ) {
+			snprintf( traceThread->name, sizeof( traceThread->name ), "%s", name );
+			traceThread->name[sizeof( traceThread->name ) - 1] = 0;
+		}
+	}
+
+	void traceWriteString( FILE *f, const char *str ) {
+		fputc( '"', f );
+		for ( ; *str; ++str ) {
+			const unsigned char c = (unsigned char)*str;
+			if ( c == '"' || c == '\\' )
+				fprintf( f, "\\%c", c );
+			else if ( c < 0x20 )
+				fprintf( f, "\\u%04x", c );
+			else
+				fputc( c, f );
+		}
+		fputc( '"', f );
+	}
+
+	inline f64 traceMicroseconds( u64 ticks ) {
+		return Clock::ms( ticks ) * 1000.0;
+	}
+
+	bool traceWrite( const char *path ) {
+		std::lock_guard<std::mutex> lock( traceThreads.lock );
+		traceDisable();
+
+		FILE *f = fopen( path, "wb" );
+		if ( !f )
+			return false;
+
+		const u32 generation = traceGeneration.load();
+		bool first = true;
+		fputs( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f );
+		for ( size_t i = 0; i < traceThreads.list.size(); i++ ) {
+			const TraceThread *t = traceThreads.list[i];
+			if ( t->generation != generation || !t->count )
+				continue;
+
+			fprintf( f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", t->id );
+			traceWriteString( f, t->name );
+			fputs( "}}", f );
+			fprintf( f, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", t->id, t->id );
+			first = false;
+
+			const u64 begin = ( t->count > t->capacity ) ? t->count - t->capacity : 0;
+			for ( u64 n = begin; n < t->count; n++ ) {
+				const TraceEvent &e = t->events[n & ( t->capacity - 1 )];
+				if ( !e.name ) {
+					fprintf( f, ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+						traceMicroseconds( e.start - traceStart ), t->id );
+				} else {
+					fputs( ",\n{\"name\":", f );
+					traceWriteString( f, e.name );
+					fprintf( f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+						traceMicroseconds( e.start - traceStart ), traceMicroseconds( e.end - e.start ), t->id );
+				}
+			}
+		}
+		fputs( "\n]}\n", f );
+
+		const bool ok = !ferror( f );
+		return ( fclose( f ) == 0 ) && ok;
+	}
+
 	/*
 	============
 	Root - Holds the root caller and the thread state for a thread
@@ -1126,6 +1362,7 @@ namespace Profiler {
 	}
 
 	void enterThread( const char *name ) {
+		traceSetThreadName( ( name[0] == '/' ) ? name + 1 : name );
 		Caller *tmp = new Caller( name );
 
 		threads.AcquireGlobalLock();
@@ -1154,6 +1391,8 @@ namespace Profiler {
 	}
 
 	inline void fastcall enterCaller( const char *name ) {
+		traceEnter( name );
+
 		Caller *parent = Caller::thisThread.activeCaller;
 		if ( !parent )
 			return;
@@ -1164,6 +1403,8 @@ namespace Profiler {
 	}
 
 	inline void exitCaller() {
+		traceExit();
+
 		Caller *active = Caller::thisThread.activeCaller;
 		if ( !active )
 			return;
@@ -1228,6 +1469,12 @@ namespace Profiler {
 	void threadenter( const char *name ) { enterThread( name ); }
 	void threadexit() { exitThread(); }
 	void reset() { resetThreads(); }
+	void tracestart( u32 eventsPerThread ) { traceBegin( eventsPerThread ); }
+	void tracestop() { traceEnd(); }
+	bool tracewrite( const char *path ) { return traceWrite( path ); }
+	bool tracing() { return traceEnabled.load(); }
+	void traceframe() { traceMarkFrame(); }
+	void threadname( const char *name ) { traceSetThreadName( name ); }
 #else
 	void detect( int argc, char **argv ) {}
 	//void detect( const char *commandLine ) {}
@@ -1240,6 +1487,12 @@ namespace Profiler {
 	void threadenter( const char *name ) {}
 	void threadexit() {}
 	void reset() {}
+	void tracestart( u32 eventsPerThread ) {}
+	void tracestop() {}
+	bool tracewrite( const char *path ) { return false; }
+	bool tracing() { return false; }
+	void traceframe() {}
+	void threadname( const char *name ) {}
 #endif
 
 } // namespace Profiler
@@ -51,6 +51,8 @@
 
 	#define PROFILE_THREAD_STOP()              Profiler::threadexit();
 
+	#define PROFILE_THREAD_NAME( name )        Profiler::threadname( name );
+
 	// function
 	#define PROFILE_PAUSE()             Profiler::pause();
 	#define PROFILE_UNPAUSE()           Profiler::unpause();
@@ -76,6 +78,8 @@
 
 	#define PROFILE_THREAD_STOP()
 
+	#define PROFILE_THREAD_NAME( name )
+
 	#define PROFILE_PAUSE()
 	#define PROFILE_UNPAUSE()
 	#define PROFILE_PAUSE_SCOPED()
@@ -261,6 +265,23 @@ namespace Profiler {
 	void threadexit();
 	void reset();
 
+	/*
+	=============
+	Tracing - records every profiled scope on every thread as a timeline and
+	writes it as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+	Each thread keeps a ring buffer of its last eventsPerThread scopes, so a
+	long trace keeps the most recent frames. Threads that never called
+	threadenter (e.g. job workers) are traced too; name them with threadname.
+	=============
+	*/
+
+	void tracestart( u32 eventsPerThread = 1 << 18 );
+	void tracestop();
+	bool tracewrite( const char *path ); // stops the trace first
+	bool tracing();
+	void traceframe(); // marks the start of a frame
+	void threadname( const char *name ); // name must outlive the thread
+
 	struct Scoped {
 		Scoped( const char *name ) { PROFILE_START_RAW( name ) }
 		~Scoped() { PROFILE_STOP() }
@@ -0,0 +1,23 @@
+-- Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+-- Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+-- Benchmark scenario: heavy combat. Two armed wings are spawned around the
+-- player and each ship is set on one of the other side.
+
+local Game = require 'Game'
+local Space = require 'Space'
+local Equipment = require 'Equipment'
+
+local types = { 'sinonatrix', 'kanara', 'pumpkinseed' }
+local red, blue = {}, {}
+
+for i = 1, 24 do
+	local ship = Space.SpawnShipNear(types[i % #types + 1], Game.player, 2, 6)
+	ship:AddEquip(Equipment.laser.pulsecannon_1mw)
+	table.insert(i % 2 == 0 and red or blue, ship)
+end
+
+for i = 1, #red do
+	red[i]:AIKill(blue[i])
+	blue[i]:AIKill(red[i])
+end
@@ -0,0 +1,23 @@
+-- Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+-- Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+-- Benchmark scenario: a planetary descent. The player starts high above the
+-- planet and the autopilot takes it down to a surface port, streaming in
+-- terrain and city detail on the way.
+
+local Game = require 'Game'
+local Space = require 'Space'
+
+local ports = Space.GetBodies(function (body)
+	return body:isa('SpaceStation') and body.isGroundStation
+end)
+
+-- prefer Cydonia on Mars, but any surface port will do
+local target = ports[1]
+for _, port in ipairs(ports) do
+	if port.label == 'Cydonia' then target = port end
+end
+
+if target then
+	Game.player:AIDockWith(target)
+end
@@ -0,0 +1,29 @@
+-- Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+-- Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+-- Benchmark scenario: a crowded station. Every free bay of the player's
+-- station is filled with a ship that undocks straight away, and a crowd of
+-- ships around the station all try to dock with it.
+
+local Game = require 'Game'
+local Space = require 'Space'
+local Engine = require 'Engine'
+
+local station = Game.player:GetDockedWith()
+if not station then return end
+
+local types = { 'kanara', 'sinonatrix', 'pumpkinseed', 'natrix', 'malabar', 'xylophis' }
+local function randomType ()
+	return types[Engine.rand:Integer(1, #types)]
+end
+
+while true do
+	local ship = Space.SpawnShipDocked(randomType(), station)
+	if not ship then break end
+	ship:Undock()
+end
+
+for i = 1, 40 do
+	local ship = Space.SpawnShipNear(randomType(), station, 5, 30)
+	ship:AIDockWith(station)
+end
@@ -6,10 +6,15 @@
 #include "FileSystem.h"
 #include "Game.h"
 #include "GameConfig.h"
+#include "JobQueue.h"
 #include "Pi.h"
 #include "Player.h"
 #include "Space.h"
 #include "StringF.h"
+#include "core/OS.h"
+#include "galaxy/Galaxy.h"
+#include "galaxy/GalaxyGenerator.h"
+#include "galaxy/Sector.h"
 #include "galaxy/StarSystem.h"
 #include "graphics/Graphics.h"
 #include "graphics/RenderState.h"
@@ -19,7 +24,11 @@
 #include "profiler/Profiler.h"
 
 #include <SDL_stdinc.h>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <list>
+#include <mutex>
 #include <sstream>
 
 using namespace Graphics;
@@ -46,6 +55,190 @@ namespace {
 		}
 		return num_matching;
 	}
+
+	// a star system of the galaxy as seen from the current system, before its
+	// brightness is mapped to a size and colour
+	struct PickedStar {
+		vector3f pos;
+		Color col;
+		float brightness;
+	};
+
+	// Picks the stars around a system from the galaxy. The sectors are split
+	// into rows that worker jobs and the main thread claim in order, and the
+	// rows are merged in the same order the sectors used to be walked in.
+	class StarPicker {
+	public:
+		StarPicker(Galaxy *galaxy, GalaxyGenerator *generator, const SystemPath &current, Sint32 visibleRadius, Uint32 maxStars) :
+			m_galaxy(galaxy),
+			m_generator(generator),
+			m_current(current),
+			m_visibleRadius(visibleRadius),
+			m_sectorMin(-(visibleRadius / Sector::SIZE)), // lyrs_radius / sector_size_in_lyrs
+			m_sectorMax(visibleRadius / Sector::SIZE),
+			m_maxStars(maxStars),
+			m_nextRow(0),
+			m_numPicked(0),
+			m_rowsDone(0)
+		{
+			const Sint32 width = std::max(m_sectorMax - m_sectorMin, 0);
+			m_rows.resize(width * width);
+		}
+
+		// RUNS IN ANY THREAD, claims rows until there are none left
+		void Run()
+		{
+			PROFILE_SCOPED()
+			for (Uint32 row = m_nextRow++; row < m_rows.size(); row = m_nextRow++) {
+				// every row before this one has been claimed, if the finished
+				// ones already fill the starfield this one would be cut off
+				if (m_numPicked < m_maxStars) {
+					PickRow(row);
+					m_numPicked += Uint32(m_rows[row].size());
+				}
+
+				std::lock_guard<std::mutex> lock(m_doneLock);
+				if (++m_rowsDone == m_rows.size())
+					m_done.notify_all();
+			}
+		}
+
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock(m_doneLock);
+			m_done.wait(lock, [this] { return m_rowsDone == m_rows.size(); });
+		}
+
+		void Merge(std::vector<PickedStar> &out)
+		{
+			for (const std::vector<PickedStar> &row : m_rows) {
+				const size_t count = std::min(row.size(), m_maxStars - out.size());
+				out.insert(out.end(), row.begin(), row.begin() + count);
+			}
+		}
+
+	private:
+		void PickRow(Uint32 row)
+		{
+			const Sint32 width = m_sectorMax - m_sectorMin;
+			const Sint32 x = m_sectorMin + Sint32(row) / width;
+			const Sint32 y = m_sectorMin + Sint32(row) % width;
+			const Sint32 visibleRadiusSqr = (m_visibleRadius * m_visibleRadius);
+			std::vector<PickedStar> &out = m_rows[row];
+
+			for (Sint32 z = m_sectorMin; z < m_sectorMax && out.size() < m_maxStars; z++) {
+				SystemPath sys(m_current.sectorX + x, m_current.sectorY + y, m_current.sectorZ + z);
+				if (SystemPath::SectorDistanceSqr(sys, m_current) * Sector::SIZE >= visibleRadiusSqr)
+					continue; // early out
+
+				// this is fairly expensive, and not shared with the galaxy's
+				// sector cache which may only be used from the main thread
+				RefCountedPtr<Sector> sec = m_generator->Generate<Sector, SectorCache>(RefCountedPtr<Galaxy>(m_galaxy), sys, nullptr);
+
+				for (const Sector::System &ss : sec->m_systems) {
+					const vector3f distance = Sector::SIZE * vector3f(m_current.sectorX, m_current.sectorY, m_current.sectorZ) - ss.GetFullPosition();
+					if (distance.LengthSqr() >= visibleRadiusSqr)
+						continue; // too far
+
+					// add the colors and luminosities of all stars in a system together
+					float luminositySystemSum = 0.0f;
+					vector3f colorSystemSum(0.0f, 0.0f, 0.0f);
+					for (size_t i = 0; i < ss.GetNumStars(); ++i) {
+						luminositySystemSum += StarSystem::starLuminosities[ss.GetStarType(i)];
+						Color col = StarSystem::starRealColors[ss.GetStarType(i)];
+						colorSystemSum += vector3f(col.r, col.g, col.b) * luminositySystemSum;
+					}
+					colorSystemSum /= luminositySystemSum;
+
+					PickedStar star;
+					star.pos = distance.Normalized() * 1000.0f;
+					star.col = Color(colorSystemSum.x, colorSystemSum.y, colorSystemSum.z);
+					star.brightness = luminositySystemSum / (4 * M_PI * distance.Length() * distance.Length());
+					out.push_back(star);
+					if (out.size() >= m_maxStars)
+						break;
+				}
+			}
+		}
+
+		Galaxy *m_galaxy;
+		GalaxyGenerator *m_generator;
+		const SystemPath m_current;
+		const Sint32 m_visibleRadius;
+		const Sint32 m_sectorMin;
+		const Sint32 m_sectorMax;
+		const size_t m_maxStars;
+
+		std::vector<std::vector<PickedStar>> m_rows;
+		std::atomic<Uint32> m_nextRow;
+		std::atomic<Uint32> m_numPicked; // in finished rows
+
+		std::mutex m_doneLock;
+		std::condition_variable m_done;
+		size_t m_rowsDone;
+	};
+
+	class StarPickerJob : public Job {
+	public:
+		StarPickerJob(std::shared_ptr<StarPicker> picker) :
+			m_picker(picker) {}
+
+		virtual void OnRun() { m_picker->Run(); } // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
+		virtual void OnFinish() {}
+
+	private:
+		// shared, the job may only get to run after Fill has returned
+		std::shared_ptr<StarPicker> m_picker;
+	};
+
+	// the stars picked around the last few systems, so that refilling the
+	// starfield (loading a game, jumping back to where we came from) doesn't
+	// regenerate the whole neighbourhood. the galaxy is identified by its
+	// generator, which is all its contents depend on
+	struct PickedStarfield {
+		SystemPath path;
+		std::string generatorName;
+		int generatorVersion;
+		Sint32 visibleRadius;
+		Uint32 maxStars;
+		std::vector<PickedStar> stars;
+	};
+	static const size_t PICKED_STARFIELD_CACHE_SIZE = 2;
+	static std::list<PickedStarfield> s_pickedStarfields;
+
+	static const std::vector<PickedStar> &GetPickedStars(RefCountedPtr<Galaxy> galaxy, const SystemPath &current, Sint32 visibleRadius, Uint32 maxStars)
+	{
+		PROFILE_SCOPED()
+		for (auto it = s_pickedStarfields.begin(); it != s_pickedStarfields.end(); ++it) {
+			if (it->generatorName == galaxy->GetGeneratorName() && it->generatorVersion == galaxy->GetGeneratorVersion() && it->path.IsSameSystem(current) && it->visibleRadius == visibleRadius && it->maxStars == maxStars) {
+				s_pickedStarfields.splice(s_pickedStarfields.begin(), s_pickedStarfields, it);
+				return s_pickedStarfields.front().stars;
+			}
+		}
+
+		std::shared_ptr<StarPicker> picker(new StarPicker(galaxy.Get(), galaxy->GetGenerator().Get(), current, visibleRadius, maxStars));
+		{
+			// the main thread picks as well, in case the workers are busy
+			std::vector<Job::Handle> jobs;
+			jobs.reserve(OS::GetNumCores());
+			for (Uint32 i = 0; i < OS::GetNumCores(); i++)
+				jobs.push_back(Pi::GetAsyncJobQueue()->Queue(new StarPickerJob(picker)));
+			picker->Run();
+			picker->Wait();
+		}
+
+		if (s_pickedStarfields.size() >= PICKED_STARFIELD_CACHE_SIZE)
+			s_pickedStarfields.pop_back();
+		s_pickedStarfields.emplace_front();
+		PickedStarfield &entry = s_pickedStarfields.front();
+		entry.path = current.SystemOnly();
+		entry.generatorName = galaxy->GetGeneratorName();
+		entry.generatorVersion = galaxy->GetGeneratorVersion();
+		entry.visibleRadius = visibleRadius;
+		entry.maxStars = maxStars;
+		picker->Merge(entry.stars);
+		return entry.stars;
+	}
 } // namespace
 
 namespace Background {
@@ -260,65 +453,25 @@ namespace Background {
 		Uint32 num = 0;
 		if (space != nullptr && galaxy.Valid() && space->GetStarSystem() != nullptr) {
 			const SystemPath current = space->GetStarSystem()->GetPath();
+			const std::vector<PickedStar> &picked = GetPickedStars(galaxy, current, Sint32(m_visibleRadiusLy), NUM_BG_STARS);
 
-			const double size = 1.0;
-			const Sint32 visibleRadius = m_visibleRadiusLy; // lyrs
-			const Sint32 visibleRadiusSqr = (visibleRadius * visibleRadius);
-			const Sint32 sectorMin = -(visibleRadius / Sector::SIZE); // lyrs_radius / sector_size_in_lyrs
-			const Sint32 sectorMax = visibleRadius / Sector::SIZE;	  // lyrs_radius / sector_size_in_lyrs
-			for (Sint32 x = sectorMin; x < sectorMax; x++) {
-				for (Sint32 y = sectorMin; y < sectorMax; y++) {
-					for (Sint32 z = sectorMin; z < sectorMax; z++) {
-						SystemPath sys(current.sectorX + x, current.sectorY + y, current.sectorZ + z);
-						if (SystemPath::SectorDistanceSqr(sys, current) * Sector::SIZE >= visibleRadiusSqr)
-							continue; // early out
-
-						// this is fairly expensive
-						RefCountedPtr<const Sector> sec = galaxy->GetSector(sys);
-
-						// add as many systems as we can
-						const size_t numSystems = std::min(sec->m_systems.size(), (size_t)(NUM_BG_STARS - num));
-						for (size_t systemIndex = 0; systemIndex < numSystems; systemIndex++) {
-							const Sector::System *ss = &(sec->m_systems[systemIndex]);
-							const vector3f distance = Sector::SIZE * vector3f(current.sectorX, current.sectorY, current.sectorZ) - ss->GetFullPosition();
-							if (distance.LengthSqr() >= visibleRadiusSqr)
-								continue; // too far
-
-							// add the colors and luminosities of all stars in a system together
-							float luminositySystemSum = 0.0f;
-							vector3f colorSystemSum(0.0f, 0.0f, 0.0f);
-							for (size_t i = 0; i < ss->GetNumStars(); ++i) {
-								luminositySystemSum += StarSystem::starLuminosities[ss->GetStarType(i)];
-								Color col = StarSystem::starRealColors[ss->GetStarType(i)];
-								colorSystemSum += vector3f(col.r, col.g, col.b) * luminositySystemSum;
-							}
-							colorSystemSum /= luminositySystemSum;
-
-							Color col(colorSystemSum.x, colorSystemSum.y, colorSystemSum.z);
-							col.r = Clamp(col.r, (Uint8)(m_rMin * 255), (Uint8)(m_rMax * 255));
-							col.g = Clamp(col.g, (Uint8)(m_gMin * 255), (Uint8)(m_gMax * 255));
-							col.b = Clamp(col.b, (Uint8)(m_bMin * 255), (Uint8)(m_bMax * 255));
-							//const Color col(Color::PINK); // debug pink
-
-							// copy the data
-							sizes[num] = size;
-							stars[num] = distance.Normalized() * 1000.0f;
-							colors[num] = col;
-							brightness[num] = luminositySystemSum / (4 * M_PI * distance.Length() * distance.Length());
-
-							//need to keep data around for HS anim - this is stupid
-							m_hyperVtx[NUM_BG_STARS * 2 + num] = stars[num];
-							m_hyperCol[NUM_BG_STARS * 2 + num] = col * 0.8f;
-							num++;
-						}
-						if (num >= NUM_BG_STARS) {
-							x = sectorMax;
-							y = sectorMax;
-							z = sectorMax;
-							break;
-						}
-					}
-				}
+			for (const PickedStar &star : picked) {
+				Color col = star.col;
+				col.r = Clamp(col.r, (Uint8)(m_rMin * 255), (Uint8)(m_rMax * 255));
+				col.g = Clamp(col.g, (Uint8)(m_gMin * 255), (Uint8)(m_gMax * 255));
+				col.b = Clamp(col.b, (Uint8)(m_bMin * 255), (Uint8)(m_bMax * 255));
+				//const Color col(Color::PINK); // debug pink
+
+				// copy the data
+				sizes[num] = 1.0;
+				stars[num] = star.pos;
+				colors[num] = col;
+				brightness[num] = star.brightness;
+
+				//need to keep data around for HS anim - this is stupid
+				m_hyperVtx[NUM_BG_STARS * 2 + num] = stars[num];
+				m_hyperCol[NUM_BG_STARS * 2 + num] = col * 0.8f;
+				num++;
 			}
 		}
 		Output("Stars picked from galaxy: %d\n", num);
@@ -332,12 +485,14 @@ namespace Background {
 		for (Uint32 i = 0; i < num; ++i) {
 			sortedBrightnessIndex.push_back(i);
 		}
-		std::sort(sortedBrightnessIndex.begin(), sortedBrightnessIndex.end(), [&](const int a, const int b) {
-			return brightness[a] > brightness[b];
-		});
 		double medianBrightness = 0.0;
 		if (num > 0) {
-			medianBrightness = brightness[sortedBrightnessIndex[Clamp<int>(m_medianPosition * num, 0, num - 1)]];
+			// only the median is needed, not the full order
+			auto median = sortedBrightnessIndex.begin() + Clamp<int>(m_medianPosition * num, 0, num - 1);
+			std::nth_element(sortedBrightnessIndex.begin(), median, sortedBrightnessIndex.end(), [&](const int a, const int b) {
+				return brightness[a] > brightness[b];
+			});
+			medianBrightness = brightness[*median];
 		}
 
 		for (size_t j = 0; j < num; ++j) {
@@ -0,0 +1,398 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "Benchmark.h"
+#include "BaseSphere.h"
+#include "Body.h"
+#include "Frame.h"
+#include "Game.h"
+#include "GameSaveError.h"
+#include "Pi.h"
+#include "Player.h"
+#include "Ship.h"
+#include "SectorView.h"
+#include "Space.h"
+#include "WorldView.h"
+#include "galaxy/StarSystem.h"
+#include "buildopts.h"
+#include "graphics/Renderer.h"
+#include "lua/Lua.h"
+#include "lua/LuaEvent.h"
+#include "lua/LuaObject.h"
+#include "lua/LuaTimer.h"
+#include "lua/LuaUtils.h"
+#include "profiler/Profiler.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdio>
+
+enum ScenarioType {
+	SCENARIO_FLIGHT,	 // step the game in the world view
+	SCENARIO_SECTOR_MAP, // step the game in the sector view, panning across sectors
+	SCENARIO_SAVE_LOAD,	 // save and reload the game, once per step
+	SCENARIO_LUA_BINDINGS // push bodies to Lua and query them, many times per step
+};
+
+struct Benchmark::Scenario {
+	const char *name;
+	ScenarioType type;
+	SystemPath start;
+	const char *script; // run once the game has started, may be null
+	int steps;			// default number of steps
+};
+
+// body indices are those of the Sol custom system
+static const Benchmark::Scenario s_scenarios[] = {
+	// docked at Gates Spaceport, in orbit around Earth
+	{ "station", SCENARIO_FLIGHT, SystemPath(0, 0, 0, 0, 10), "benchmarks/station.lua", 3000 },
+	// high above Mars, heading for one of its surface ports
+	{ "descent", SCENARIO_FLIGHT, SystemPath(0, 0, 0, 0, 16), "benchmarks/descent.lua", 3000 },
+	// in space above the Moon
+	{ "combat", SCENARIO_FLIGHT, SystemPath(0, 0, 0, 0, 13), "benchmarks/combat.lua", 3000 },
+	// docked at Cydonia, Mars
+	{ "sectormap", SCENARIO_SECTOR_MAP, SystemPath(0, 0, 0, 0, 18), nullptr, 1000 },
+	{ "saveload", SCENARIO_SAVE_LOAD, SystemPath(0, 0, 0, 0, 18), nullptr, 20 },
+	// the combat scenario's ships, as seen from Lua
+	{ "luabindings", SCENARIO_LUA_BINDINGS, SystemPath(0, 0, 0, 0, 13), "benchmarks/combat.lua", 200 },
+};
+
+static const char BENCHMARK_SAVE_NAME[] = "_benchmark";
+
+// steps between jumps to the next sector in the sector map scenario
+static const int SECTOR_MAP_PAN_STEPS = 50;
+
+// times everything is pushed per step in the Lua bindings scenario
+static const int LUA_BINDINGS_REPEATS = 100;
+
+std::vector<std::string> Benchmark::GetScenarioNames()
+{
+	std::vector<std::string> names;
+	for (const Scenario &s : s_scenarios)
+		names.push_back(s.name);
+	return names;
+}
+
+bool Benchmark::HasScenario(const std::string &name)
+{
+	for (const Scenario &s : s_scenarios)
+		if (name == s.name) return true;
+	return false;
+}
+
+void Benchmark::Timing::Add(double ms)
+{
+	total += ms;
+	max = std::max(max, ms);
+	count++;
+}
+
+Benchmark::Benchmark(const std::vector<std::string> &scenarios, int steps, const std::string &outFile) :
+	m_current(0),
+	m_steps(0),
+	m_stepsWanted(steps),
+	m_outFile(outFile),
+	m_setupTime(0.0)
+{
+	for (const Scenario &s : s_scenarios) {
+		if (scenarios.empty() || std::find(scenarios.begin(), scenarios.end(), s.name) != scenarios.end())
+			m_scenarios.push_back(&s);
+	}
+}
+
+void Benchmark::Start()
+{
+	m_results = Json::object();
+	m_results["version"] = PIONEER_VERSION;
+	m_results["renderer"] = Pi::renderer->GetName();
+	m_results["scenarios"] = Json::object();
+
+	m_current = 0;
+	if (m_scenarios.empty() || !BeginScenario())
+		RequestEndLifecycle();
+}
+
+void Benchmark::Update(float deltaTime)
+{
+	PROFILE_SCOPED()
+	if (!Pi::game) {
+		RequestEndLifecycle();
+		return;
+	}
+
+	if (m_scenarios[m_current]->type == SCENARIO_SAVE_LOAD)
+		StepSaveLoad();
+	else if (m_scenarios[m_current]->type == SCENARIO_LUA_BINDINGS)
+		StepLuaBindings();
+	else
+		StepGame();
+
+	++m_steps;
+	const int steps = m_stepsWanted > 0 ? m_stepsWanted : m_scenarios[m_current]->steps;
+	const bool playerDied = Pi::game && Pi::player->IsDead();
+	if (m_steps < steps && !playerDied && Pi::game)
+		return;
+
+	EndScenario();
+	while (++m_current < m_scenarios.size()) {
+		if (BeginScenario())
+			return;
+	}
+	RequestEndLifecycle();
+}
+
+void Benchmark::End()
+{
+	if (Pi::game)
+		EndGame();
+
+	WriteResults();
+}
+
+bool Benchmark::BeginScenario()
+{
+	const Scenario &s = *m_scenarios[m_current];
+	Output("Benchmark: starting scenario '%s'\n", s.name);
+
+	m_steps = 0;
+	m_timings.clear();
+
+	// same random numbers for the game and the scripts on every run
+	Pi::rng.seed(0);
+
+	Profiler::Clock timer;
+	timer.Start();
+
+	try {
+		StartGame(new Game(s.start));
+	} catch (const InvalidGameStartLocation &e) {
+		Output("Benchmark: scenario '%s' has an invalid start location: %s\n", s.name, e.error.c_str());
+		m_results["scenarios"][s.name] = { { "error", e.error } };
+		return false;
+	}
+
+	if (s.script)
+		pi_lua_dofile(Lua::manager->GetLuaState(), s.script);
+
+	if (s.type == SCENARIO_SECTOR_MAP) {
+		SectorView *sectorView = Pi::game->GetSectorView();
+		Pi::SetView(sectorView);
+		// zoom out far enough for the far sectors to be drawn too
+		for (int i = 0; i < 5; i++)
+			sectorView->ZoomOut();
+	}
+
+	timer.Stop();
+	m_setupTime = timer.milliseconds();
+
+	return true;
+}
+
+void Benchmark::EndScenario()
+{
+	const Scenario &s = *m_scenarios[m_current];
+
+	Json subsystems = Json::object();
+	for (const auto &t : m_timings) {
+		subsystems[t.first] = {
+			{ "total_ms", t.second.total },
+			{ "mean_ms", t.second.count ? t.second.total / t.second.count : 0.0 },
+			{ "max_ms", t.second.max }
+		};
+	}
+
+	Json result = Json::object();
+	result["steps"] = m_steps;
+	result["setup_ms"] = m_setupTime;
+	result["player_died"] = Pi::game && Pi::player->IsDead();
+	result["subsystems"] = subsystems;
+	m_results["scenarios"][s.name] = result;
+
+	Output("Benchmark: scenario '%s' ran %d steps\n", s.name, m_steps);
+
+	if (Pi::game)
+		EndGame();
+}
+
+// one physics step and one frame, broken down the same way as the game loop
+void Benchmark::StepGame()
+{
+	Profiler::Clock frame, timer;
+	frame.Start();
+
+	timer.Start();
+	Pi::game->TimeStep(Pi::game->GetTimeStep());
+	timer.Stop();
+	m_timings["timestep"].Add(timer.milliseconds());
+
+	const Space::TimeStepStats &stats = Pi::game->GetSpace()->GetTimeStepStats();
+	m_timings["collisions"].Add(stats.collisions);
+	m_timings["dynamics"].Add(stats.dynamics);
+	m_timings["lua"].Add(stats.lua);
+	m_timings["bodies"].Add(stats.bodies);
+
+	timer.SoftReset();
+	BaseSphere::UpdateAllBaseSphereDerivatives();
+	timer.SoftStop();
+	m_timings["terrain"].Add(timer.milliseconds());
+
+	if (m_scenarios[m_current]->type == SCENARIO_SECTOR_MAP && m_steps % SECTOR_MAP_PAN_STEPS == 0) {
+		const SystemPath &start = m_scenarios[m_current]->start;
+		const int leg = m_steps / SECTOR_MAP_PAN_STEPS;
+		Pi::game->GetSectorView()->GotoSector(SystemPath(start.sectorX + leg % 8, start.sectorY + leg / 8, start.sectorZ));
+	}
+
+	timer.SoftReset();
+	Pi::renderer->SetTransform(matrix4x4f::Identity());
+	// every frame renders the state at the end of its physics step
+	Pi::SetGameTickAlpha(1.0f);
+	for (Body *b : Pi::game->GetSpace()->GetBodies())
+		b->UpdateInterpTransform(Pi::GetGameTickAlpha());
+	Frame::GetFrame(Pi::game->GetSpace()->GetRootFrame())->UpdateInterpTransform(Pi::GetGameTickAlpha());
+	timer.SoftStop();
+	m_timings["interpolation"].Add(timer.milliseconds());
+
+	timer.SoftReset();
+	Pi::GetView()->Update();
+	Pi::GetView()->Draw3D();
+	timer.SoftStop();
+	m_timings["view"].Add(timer.milliseconds());
+
+	timer.SoftReset();
+	Pi::GetApp()->RunJobs();
+	timer.SoftStop();
+	m_timings["jobs"].Add(timer.milliseconds());
+
+	frame.Stop();
+	m_timings["frame"].Add(frame.milliseconds());
+}
+
+void Benchmark::StepSaveLoad()
+{
+	Profiler::Clock timer;
+
+	timer.Start();
+	try {
+		Game::SaveGame(BENCHMARK_SAVE_NAME, Pi::game);
+	} catch (...) {
+		Output("Benchmark: couldn't save the game\n");
+		EndGame();
+		return;
+	}
+	timer.Stop();
+	m_timings["save"].Add(timer.milliseconds());
+
+	timer.SoftReset();
+	EndGame();
+	timer.SoftStop();
+	m_timings["end_game"].Add(timer.milliseconds());
+
+	timer.SoftReset();
+	try {
+		StartGame(Game::LoadGame(BENCHMARK_SAVE_NAME));
+	} catch (...) {
+		Output("Benchmark: couldn't load the game\n");
+		return;
+	}
+	timer.SoftStop();
+	m_timings["load"].Add(timer.milliseconds());
+}
+
+// the bindings that are hit hardest by event arguments and Space queries
+void Benchmark::StepLuaBindings()
+{
+	lua_State *l = Lua::manager->GetLuaState();
+	auto bodies = Pi::game->GetSpace()->GetBodies();
+	Profiler::Clock frame, timer;
+	frame.Start();
+
+	timer.Start();
+	for (int i = 0; i < LUA_BINDINGS_REPEATS; i++) {
+		for (Body *b : bodies) {
+			LuaObject<Body>::PushToLua(b);
+			lua_pop(l, 1);
+		}
+	}
+	timer.Stop();
+	m_timings["push_body"].Add(timer.milliseconds());
+
+	timer.SoftReset();
+	for (int i = 0; i < LUA_BINDINGS_REPEATS; i++) {
+		for (Body *b : bodies) {
+			if (!b->IsType(Object::SHIP))
+				continue;
+			LuaObject<Ship>::PushToLua(static_cast<Ship *>(b));
+			lua_pop(l, 1);
+		}
+	}
+	timer.SoftStop();
+	m_timings["push_ship"].Add(timer.milliseconds());
+
+	const SystemPath &path = Pi::game->GetSpace()->GetStarSystem()->GetPath();
+	const Uint32 numBodies = Pi::game->GetSpace()->GetNumBodies();
+	timer.SoftReset();
+	for (int i = 0; i < LUA_BINDINGS_REPEATS; i++) {
+		for (Uint32 j = 0; j < numBodies; j++) {
+			LuaObject<SystemPath>::PushToLua(path);
+			lua_pop(l, 1);
+		}
+	}
+	timer.SoftStop();
+	m_timings["push_systempath"].Add(timer.milliseconds());
+
+	// Space.GetBodies() pushes every body into a new table
+	pi_lua_import(l, "Space");
+	lua_getfield(l, -1, "GetBodies");
+	timer.SoftReset();
+	for (int i = 0; i < LUA_BINDINGS_REPEATS; i++) {
+		lua_pushvalue(l, -1);
+		pi_lua_protected_call(l, 0, 1);
+		lua_pop(l, 1);
+	}
+	timer.SoftStop();
+	m_timings["space_get_bodies"].Add(timer.milliseconds());
+	lua_pop(l, 2);
+
+	frame.Stop();
+	m_timings["frame"].Add(frame.milliseconds());
+}
+
+// the parts of GameLoop::Start and GameLoop::End that matter without a player at the controls
+void Benchmark::StartGame(Game *game)
+{
+	Pi::game = game;
+
+	LuaEvent::Clear();
+	Pi::SetView(Pi::game->GetWorldView());
+
+	LuaEvent::Queue("onGameStart");
+	LuaEvent::Emit();
+}
+
+void Benchmark::EndGame()
+{
+	Pi::SetView(nullptr);
+
+	LuaEvent::Queue("onGameEnd");
+	LuaEvent::Emit();
+
+	Pi::luaTimer->RemoveAll();
+	Lua::manager->CollectGarbage();
+
+	delete Pi::game;
+	Pi::game = nullptr;
+	Pi::player = nullptr;
+}
+
+void Benchmark::WriteResults()
+{
+	const std::string text = m_results.dump(1, '\t') + "\n";
+
+	FILE *f = m_outFile.empty() ? stdout : fopen(m_outFile.c_str(), "w");
+	if (!f) {
+		Output("Benchmark: could not open %s for writing\n", m_outFile.c_str());
+		return;
+	}
+	fwrite(text.data(), 1, text.size(), f);
+	if (f != stdout)
+		fclose(f);
+}
@@ -0,0 +1,67 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "Json.h"
+#include "core/Application.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class Game;
+
+/*
+ * Runs scripted game scenarios for a fixed number of timesteps, one step per
+ * frame, and writes out how long each part of the frame took as JSON.
+ * Meant to be run headless by pioneer-bench, with the dummy renderer.
+ */
+class Benchmark : public Application::Lifecycle {
+public:
+	struct Scenario;
+
+	static std::vector<std::string> GetScenarioNames();
+	static bool HasScenario(const std::string &name);
+
+	// steps <= 0 runs each scenario for its own default number of steps.
+	// an empty output file name writes to stdout
+	Benchmark(const std::vector<std::string> &scenarios, int steps, const std::string &outFile);
+
+protected:
+	void Start() override;
+	void Update(float deltaTime) override;
+	void End() override;
+
+private:
+	struct Timing {
+		double total = 0.0;
+		double max = 0.0;
+		int count = 0;
+
+		void Add(double ms);
+	};
+
+	bool BeginScenario();
+	void EndScenario();
+	void StepGame();
+	void StepSaveLoad();
+	void StepLuaBindings();
+
+	void StartGame(Game *game);
+	void EndGame();
+
+	void WriteResults();
+
+	std::vector<const Scenario *> m_scenarios;
+	size_t m_current;
+	int m_steps;
+	int m_stepsWanted;
+	std::string m_outFile;
+
+	double m_setupTime;
+	std::map<std::string, Timing> m_timings;
+	Json m_results;
+};
+
+#endif /* _BENCHMARK_H */
@@ -10,7 +10,6 @@
 #include "Missile.h"
 #include "Planet.h"
 #include "Player.h"
-#include "Projectile.h"
 #include "Ship.h"
 #include "Space.h"
 #include "SpaceStation.h"
@@ -90,7 +89,6 @@ void Body::ToJson(Json &jsonObj, Space *space)
 	case Object::PLAYER:
 	case Object::MISSILE:
 	case Object::CARGOBODY:
-	case Object::PROJECTILE:
 	case Object::HYPERSPACECLOUD:
 		SaveToJson(jsonObj, space);
 		break;
@@ -126,8 +124,6 @@ Body *Body::FromJson(const Json &jsonObj, Space *space)
 	}
 	case Object::MISSILE:
 		return new Missile(jsonObj, space);
-	case Object::PROJECTILE:
-		return new Projectile(jsonObj, space);
 	case Object::CARGOBODY:
 		return new CargoBody(jsonObj, space);
 	case Object::HYPERSPACECLOUD:
@@ -141,20 +137,14 @@ Body *Body::FromJson(const Json &jsonObj, Space *space)
 
 vector3d Body::GetPositionRelTo(FrameId relToId) const
 {
-	Frame *frame = Frame::GetFrame(m_frame);
-
-	vector3d fpos = frame->GetPositionRelTo(relToId);
-	matrix3x3d forient = frame->GetOrientRelTo(relToId);
-	return forient * GetPosition() + fpos;
+	const Frame::RelTransform t = Frame::GetFrame(m_frame)->GetCachedTransformRelTo(relToId);
+	return t.orient * GetPosition() + t.pos;
 }
 
 vector3d Body::GetInterpPositionRelTo(FrameId relToId) const
 {
-	Frame *frame = Frame::GetFrame(m_frame);
-
-	vector3d fpos = frame->GetInterpPositionRelTo(relToId);
-	matrix3x3d forient = frame->GetInterpOrientRelTo(relToId);
-	return forient * GetInterpPosition() + fpos;
+	const Frame::RelTransform t = Frame::GetFrame(m_frame)->GetCachedInterpTransformRelTo(relToId);
+	return t.orient * GetInterpPosition() + t.pos;
 }
 
 vector3d Body::GetPositionRelTo(const Body *relTo) const
@@ -169,28 +159,24 @@ vector3d Body::GetInterpPositionRelTo(const Body *relTo) const
 
 matrix3x3d Body::GetOrientRelTo(FrameId relToId) const
 {
-	Frame *frame = Frame::GetFrame(m_frame);
-
-	matrix3x3d forient = frame->GetOrientRelTo(relToId);
-	return forient * GetOrient();
+	const Frame::RelTransform t = Frame::GetFrame(m_frame)->GetCachedTransformRelTo(relToId);
+	return t.orient * GetOrient();
 }
 
 matrix3x3d Body::GetInterpOrientRelTo(FrameId relToId) const
 {
-	Frame *frame = Frame::GetFrame(m_frame);
-
-	matrix3x3d forient = frame->GetInterpOrientRelTo(relToId);
-	return forient * GetInterpOrient();
+	const Frame::RelTransform t = Frame::GetFrame(m_frame)->GetCachedInterpTransformRelTo(relToId);
+	return t.orient * GetInterpOrient();
 }
 
 vector3d Body::GetVelocityRelTo(FrameId relToId) const
 {
 	Frame *frame = Frame::GetFrame(m_frame);
 
-	matrix3x3d forient = frame->GetOrientRelTo(relToId);
+	const Frame::RelTransform t = frame->GetCachedTransformRelTo(relToId);
 	vector3d vel = GetVelocity();
 	if (m_frame != relToId) vel -= frame->GetStasisVelocity(GetPosition());
-	return forient * vel + frame->GetVelocityRelTo(relToId);
+	return t.orient * vel + t.vel;
 }
 
 vector3d Body::GetVelocityRelTo(const Body *relTo) const
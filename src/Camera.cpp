@@ -9,6 +9,7 @@
 #include "Pi.h"
 #include "Planet.h"
 #include "Player.h"
+#include "Projectile.h"
 #include "Sfx.h"
 #include "Space.h"
 #include "galaxy/StarSystem.h"
@@ -16,8 +17,7 @@
 
 using namespace Graphics;
 
-// if a body would render smaller than this many pixels, just ignore it
-static const float OBJECT_HIDDEN_PIXEL_THRESHOLD = 2.0f;
+const float Camera::OBJECT_HIDDEN_PIXEL_THRESHOLD = 2.0f;
 
 // if a terrain object would render smaller than this many pixels, draw a billboard instead
 static const float BILLBOARD_PIXEL_THRESHOLD = 8.0f;
@@ -134,31 +134,60 @@ static void position_system_lights(Frame *camFrame, Frame *frame, std::vector<Ca
 
 void Camera::Update()
 {
+	PROFILE_SCOPED()
 	FrameId camFrame = m_context->GetTempFrame();
 
-	// evaluate each body and determine if/where/how to draw it
 	m_sortedBodies.clear();
+	m_occluders.clear();
+	m_cullSpheres.x.clear();
+	m_cullSpheres.y.clear();
+	m_cullSpheres.z.clear();
+	m_cullSpheres.radius.clear();
+
+	// position every drawable body in camera space
 	for (Body *b : Pi::game->GetSpace()->GetBodies()) {
-		BodyAttrs attrs;
-		attrs.body = b;
-		attrs.billboard = false; // false by default
+		if (b->IsType(Object::PLANET) || b->IsType(Object::STAR))
+			m_occluders.push_back({ b, b->GetSystemBody()->GetRadius() });
 
 		// If the body wishes to be excluded from the draw, skip it.
 		if (b->GetFlags() & Body::FLAG_DRAW_EXCLUDE)
 			continue;
 
+		BodyAttrs attrs;
+		attrs.body = b;
+		attrs.billboard = false; // false by default
+
 		// determine position and transform for draw
 		//		Frame::GetFrameTransform(b->GetFrame(), camFrame, attrs.viewTransform);		// doesn't use interp coords, so breaks in some cases
 		Frame *f = Frame::GetFrame(b->GetFrame());
 		attrs.viewTransform = f->GetInterpOrientRelTo(camFrame);
 		attrs.viewTransform.SetTranslate(f->GetInterpPositionRelTo(camFrame));
 		attrs.viewCoords = attrs.viewTransform * b->GetInterpPosition();
+		m_sortedBodies.push_back(attrs);
+
+		m_cullSpheres.x.push_back(attrs.viewCoords.x);
+		m_cullSpheres.y.push_back(attrs.viewCoords.y);
+		m_cullSpheres.z.push_back(attrs.viewCoords.z);
+		m_cullSpheres.radius.push_back(b->GetClipRadius());
+	}
 
-		// cull off-screen objects
-		double rad = b->GetClipRadius();
-		if (!m_context->GetFrustum().TestPointInfinite(attrs.viewCoords, rad))
+	// cull off-screen objects
+	const size_t numCandidates = m_sortedBodies.size();
+	m_cullSpheres.visible.resize(numCandidates);
+	m_context->GetFrustum().TestPointsInfinite(numCandidates, m_cullSpheres.x.data(), m_cullSpheres.y.data(),
+		m_cullSpheres.z.data(), m_cullSpheres.radius.data(), m_cullSpheres.visible.data());
+
+	// evaluate each visible body and determine if/how to draw it, compacting
+	// the list in place
+	size_t numVisible = 0;
+	for (size_t i = 0; i < numCandidates; i++) {
+		if (!m_cullSpheres.visible[i])
 			continue;
 
+		BodyAttrs &attrs = m_sortedBodies[i];
+		Body *b = attrs.body;
+		const double rad = m_cullSpheres.radius[i];
+
 		attrs.camDist = attrs.viewCoords.Length();
 		attrs.bodyFlags = b->GetFlags();
 
@@ -199,11 +228,24 @@ void Camera::Update()
 			continue;
 		}
 
-		m_sortedBodies.push_back(attrs);
+		if (numVisible != i)
+			m_sortedBodies[numVisible] = attrs;
+		numVisible++;
 	}
-
-	// depth sort
-	m_sortedBodies.sort();
+	m_sortedBodies.resize(numVisible);
+
+	// depth sort. the entries are big, so sort indices to them instead; ties
+	// keep the order of the body list so equal bodies don't swap from frame to frame
+	m_drawOrder.resize(numVisible);
+	for (Uint32 i = 0; i < numVisible; i++)
+		m_drawOrder[i] = i;
+	std::sort(m_drawOrder.begin(), m_drawOrder.end(), [this](Uint32 a, Uint32 b) {
+		const BodyAttrs &attrsA = m_sortedBodies[a];
+		const BodyAttrs &attrsB = m_sortedBodies[b];
+		if (attrsA < attrsB) return true;
+		if (attrsB < attrsA) return false;
+		return a < b;
+	});
 }
 
 void Camera::Draw(const Body *excludeBody)
@@ -274,8 +316,8 @@ void Camera::Draw(const Body *excludeBody)
 		m_renderer->SetLights(rendererLights.size(), &rendererLights[0]);
 	}
 
-	for (std::list<BodyAttrs>::iterator i = m_sortedBodies.begin(); i != m_sortedBodies.end(); ++i) {
-		BodyAttrs *attrs = &(*i);
+	for (Uint32 i : m_drawOrder) {
+		BodyAttrs *attrs = &m_sortedBodies[i];
 
 		// explicitly exclude a single body if specified (eg player)
 		if (attrs->body == excludeBody)
@@ -290,6 +332,8 @@ void Camera::Draw(const Body *excludeBody)
 			attrs->body->Render(m_renderer, this, attrs->viewCoords, attrs->viewTransform);
 	}
 
+	Pi::game->GetSpace()->GetProjectiles()->Render(m_renderer, this, camFrameId);
+
 	SfxManager::RenderAll(m_renderer, rootFrameId, camFrameId);
 }
 
@@ -311,11 +355,12 @@ void Camera::CalcShadows(const int lightNum, const Body *b, std::vector<Shadow>
 		bRadius = b->GetPhysRadius();
 
 	// Look for eclipsing third bodies:
-	for (const Body *b2 : Pi::game->GetSpace()->GetBodies()) {
-		if (b2 == b || b2 == lightBody || !(b2->IsType(Object::PLANET) || b2->IsType(Object::STAR)))
+	for (const Occluder &occluder : m_occluders) {
+		const Body *b2 = occluder.body;
+		if (b2 == b || b2 == lightBody)
 			continue;
 
-		double b2Radius = b2->GetSystemBody()->GetRadius();
+		double b2Radius = occluder.radius;
 		vector3d b2pos = b2->GetPositionRelTo(b);
 		const double perpDist = lightDir.Dot(b2pos);
 
@@ -75,6 +75,9 @@ private:
 
 class Camera {
 public:
+	// if a body would render smaller than this many pixels, just ignore it
+	static const float OBJECT_HIDDEN_PIXEL_THRESHOLD;
+
 	Camera(RefCountedPtr<CameraContext> context, Graphics::Renderer *renderer);
 
 	const CameraContext *GetContext() const { return m_context.Get(); }
@@ -149,7 +152,26 @@ private:
 		};
 	};
 
-	std::list<BodyAttrs> m_sortedBodies;
+	// the bodies in view this frame and the order to draw them in. both are
+	// only cleared between frames, to keep their storage
+	std::vector<BodyAttrs> m_sortedBodies;
+	std::vector<Uint32> m_drawOrder;
+
+	// camera space bounding spheres of all candidate bodies, kept as separate
+	// arrays so the frustum can test them in one pass
+	struct CullSpheres {
+		std::vector<double> x, y, z, radius;
+		std::vector<Uint8> visible;
+	};
+	CullSpheres m_cullSpheres;
+
+	// planets and stars that can eclipse a light source, gathered once per
+	// frame in Update for CalcShadows
+	struct Occluder {
+		const Body *body;
+		double radius;
+	};
+	std::vector<Occluder> m_occluders;
 	std::vector<LightSource> m_lightSources;
 };
 
@@ -16,9 +16,13 @@
 #include "scenegraph/ModelSkin.h"
 #include "scenegraph/SceneGraph.h"
 
+#include <map>
+
 static const unsigned int DEFAULT_NUM_BUILDINGS = 1000;
 static const double START_SEG_SIZE = CITY_ON_PLANET_RADIUS;
 static const double START_SEG_SIZE_NO_ATMO = CITY_ON_PLANET_RADIUS / 5.0f;
+// side length of the patches the city is frustum culled in, 4x4 building cells
+static const double CHUNK_SIZE = 320.0;
 
 using SceneGraph::Model;
 
@@ -74,6 +78,60 @@ void CityOnPlanet::AddStaticGeomsToCollisionSpace()
 
 	// reset the reset flag
 	m_detailLevel = Pi::detail.cities;
+
+	BuildInstanceChunks();
+}
+
+void CityOnPlanet::BuildInstanceChunks()
+{
+	PROFILE_SCOPED()
+	m_chunks.clear();
+	m_instanceRanges.clear();
+	m_instanceTransforms.clear();
+	m_instanceTransforms.reserve(m_enabledBuildings.size());
+	m_visibleTransforms.resize(s_buildingList.numBuildings);
+
+	const vector3d mx = m_stationOrient * vector3d(1, 0, 0);
+	const vector3d mz = m_stationOrient * vector3d(0, 0, 1);
+
+	matrix4x4d orientcalc[4];
+	for (int i = 0; i < 4; i++)
+		orientcalc[i] = m_stationOrient * matrix4x4d::RotateYMatrix(M_PI * 0.5 * double(i));
+
+	// bucket the buildings by chunk, then by type
+	typedef std::pair<int, int> ChunkKey;
+	std::map<ChunkKey, std::map<Uint32, std::vector<const BuildingDef *>>> chunkMap;
+	for (const BuildingDef &b : m_enabledBuildings) {
+		const vector3d local = b.pos - m_stationPos;
+		const ChunkKey key(int(floor(local.Dot(mx) / CHUNK_SIZE)), int(floor(local.Dot(mz) / CHUNK_SIZE)));
+		chunkMap[key][b.instIndex].push_back(&b);
+	}
+
+	m_chunks.reserve(chunkMap.size());
+	for (const auto &chunkIt : chunkMap) {
+		CityChunk chunk;
+		chunk.firstRange = Uint32(m_instanceRanges.size());
+		chunk.numRanges = Uint32(chunkIt.second.size());
+
+		Aabb bounds;
+		double maxClipRadius = 0.0;
+		for (const auto &typeIt : chunkIt.second) {
+			m_instanceRanges.push_back({ typeIt.first, Uint32(m_instanceTransforms.size()), Uint32(typeIt.second.size()) });
+			for (const BuildingDef *b : typeIt.second) {
+				const vector3d local = b->pos - m_stationPos;
+				matrix4x4d trans(orientcalc[b->rotation]);
+				trans.SetTranslate(local);
+				m_instanceTransforms.push_back(matrix4x4f(trans));
+
+				bounds.Update(local);
+				maxClipRadius = std::max(maxClipRadius, double(b->clipRadius));
+			}
+		}
+
+		chunk.centre = (bounds.min + bounds.max) * 0.5;
+		chunk.clipRadius = (bounds.max - bounds.min).Length() * 0.5 + maxClipRadius;
+		m_chunks.push_back(chunk);
+	}
 }
 
 void CityOnPlanet::RemoveStaticGeomsFromCollisionSpace()
@@ -211,6 +269,8 @@ CityOnPlanet::CityOnPlanet(Planet *planet, SpaceStation *station, const Uint32 s
 	const Aabb &aabb = station->GetAabb();
 	const matrix4x4d &m = station->GetOrient();
 	const vector3d p = station->GetPosition();
+	m_stationPos = p;
+	m_stationOrient = m;
 
 	const vector3d mx = m * vector3d(1, 0, 0);
 	const vector3d mz = m * vector3d(0, 0, 1);
@@ -321,10 +381,6 @@ void CityOnPlanet::Render(Graphics::Renderer *r, const Graphics::Frustum &frustu
 	if (!frustum.TestPoint(stationPos, m_clipRadius))
 		return;
 
-	matrix4x4d rot[4];
-	matrix4x4f rotf[4];
-	rot[0] = station->GetOrient();
-
 	// change detail level if necessary
 	const bool bDetailChanged = m_detailLevel != Pi::detail.cities;
 	if (bDetailChanged) {
@@ -332,16 +388,6 @@ void CityOnPlanet::Render(Graphics::Renderer *r, const Graphics::Frustum &frustu
 		AddStaticGeomsToCollisionSpace();
 	}
 
-	rot[0] = viewTransform * rot[0];
-	for (int i = 1; i < 4; i++) {
-		rot[i] = rot[0] * matrix4x4d::RotateYMatrix(M_PI * 0.5 * double(i));
-	}
-	for (int i = 0; i < 4; i++) {
-		for (int e = 0; e < 16; e++) {
-			rotf[i][e] = float(rot[i][e]);
-		}
-	}
-
 	// update any idle animations
 	for (Uint32 i = 0; i < s_buildingList.numBuildings; i++) {
 		SceneGraph::Animation *pAnim = s_buildingList.buildings[i].idle;
@@ -351,36 +397,33 @@ void CityOnPlanet::Render(Graphics::Renderer *r, const Graphics::Frustum &frustu
 		}
 	}
 
-	Uint32 uCount = 0;
-	std::vector<Uint32> instCount;
-	std::vector<std::vector<matrix4x4f>> transform;
-	instCount.resize(s_buildingList.numBuildings);
-	transform.resize(s_buildingList.numBuildings);
-	memset(&instCount[0], 0, sizeof(Uint32) * s_buildingList.numBuildings);
-	for (Uint32 i = 0; i < s_buildingList.numBuildings; i++) {
-		transform[i].reserve(m_buildingCounts[i]);
-	}
-
-	for (std::vector<BuildingDef>::const_iterator iter = m_enabledBuildings.begin(), itEND = m_enabledBuildings.end(); iter != itEND; ++iter) {
-		const vector3d pos = viewTransform * (*iter).pos;
-		const vector3f posf(pos);
-		if (!frustum.TestPoint(pos, (*iter).clipRadius))
-			continue;
+	// the instance transforms are relative to the station,
+	// so all that changes from frame to frame is the base they're drawn from
+	const matrix4x4d base = viewTransform * matrix4x4d::Translation(m_stationPos);
+	const matrix4x4f basef(base);
 
-		matrix4x4f _rot(rotf[(*iter).rotation]);
-		_rot.SetTranslate(posf);
+	for (std::vector<matrix4x4f> &transforms : m_visibleTransforms)
+		transforms.clear();
 
-		// increment the instance count and store the transform
-		instCount[(*iter).instIndex]++;
-		transform[(*iter).instIndex].push_back(_rot);
+	// cull whole chunks, clipping of the individual buildings is left to the GPU
+	Uint32 uCount = 0;
+	for (const CityChunk &chunk : m_chunks) {
+		if (!frustum.TestPoint(base * chunk.centre, chunk.clipRadius))
+			continue;
 
-		++uCount;
+		for (Uint32 i = chunk.firstRange; i < chunk.firstRange + chunk.numRanges; i++) {
+			const InstanceRange &range = m_instanceRanges[i];
+			const matrix4x4f *first = &m_instanceTransforms[range.first];
+			std::vector<matrix4x4f> &transforms = m_visibleTransforms[range.instIndex];
+			transforms.insert(transforms.end(), first, first + range.count);
+			uCount += range.count;
+		}
 	}
 
-	// render the building models using instancing
+	// render the building models using instancing, one batch per building type
 	for (Uint32 i = 0; i < s_buildingList.numBuildings; i++) {
-		if (!transform[i].empty())
-			s_buildingList.buildings[i].resolvedModel->Render(transform[i]);
+		if (!m_visibleTransforms[i].empty())
+			s_buildingList.buildings[i].resolvedModel->Render(basef, m_visibleTransforms[i]);
 	}
 
 	r->GetStats().AddToStatCount(Graphics::Stats::STAT_BUILDINGS, uCount);
@@ -44,6 +44,7 @@ public:
 private:
 	void AddStaticGeomsToCollisionSpace();
 	void RemoveStaticGeomsFromCollisionSpace();
+	void BuildInstanceChunks();
 
 	struct BuildingDef {
 		Uint32 instIndex;
@@ -53,6 +54,22 @@ private:
 		Geom *geom;
 	};
 
+	// A square patch of the city, culled as a whole. Its buildings' transforms are
+	// stored relative to the station, grouped by building type, so that rendering
+	// only has to append the visible ranges for each type.
+	struct InstanceRange {
+		Uint32 instIndex;
+		Uint32 first;
+		Uint32 count;
+	};
+
+	struct CityChunk {
+		vector3d centre; // relative to the station
+		double clipRadius;
+		Uint32 firstRange;
+		Uint32 numRanges;
+	};
+
 	Planet *m_planet;
 	FrameId m_frame;
 	std::vector<BuildingDef> m_buildings;
@@ -62,6 +79,14 @@ private:
 	vector3d m_realCentre;
 	float m_clipRadius;
 
+	vector3d m_stationPos;
+	matrix4x4d m_stationOrient;
+	std::vector<CityChunk> m_chunks;
+	std::vector<InstanceRange> m_instanceRanges;
+	std::vector<matrix4x4f> m_instanceTransforms;
+	// visible instances per building type, reused from frame to frame
+	std::vector<std::vector<matrix4x4f>> m_visibleTransforms;
+
 	// --------------------------------------------------------
 	// statics
 	static const unsigned int CITYFLAVOURS = 5;
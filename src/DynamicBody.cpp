@@ -13,6 +13,21 @@
 #include "ship/Propulsion.h"
 
 static const float KINETIC_ENERGY_MULT = 0.00001f;
+
+// coasting bodies follow their orbit analytically once a tick is this long
+// (100x time acceleration and up), where explicit integration of a tight
+// orbit starts to drift badly
+static const float RAILS_MIN_TIMESTEP = 1.0f;
+// closer than this many radii of the body they orbit, bodies are integrated
+// again so terrain collisions, atmosphere and frame changes are handled
+static const double RAILS_MIN_RADII = 2.0;
+// integrated bodies split long ticks into substeps no longer than this
+// fraction of the orbital time scale sqrt(r^3/GM) of their frame body...
+static const double SUBSTEP_ORBIT_FRACTION = 0.02;
+// ...and short enough not to close more than this fraction of the distance
+// to its surface in one substep
+static const double SUBSTEP_APPROACH_FRACTION = 0.1;
+static const int MAX_SUBSTEPS = 16;
 const double DynamicBody::DEFAULT_DRAG_COEFF = 0.1; // 'smooth sphere'
 
 DynamicBody::DynamicBody() :
@@ -41,6 +56,7 @@ DynamicBody::DynamicBody() :
 	m_decelerating = false;
 	for (int i = 0; i < Feature::MAX_FEATURE; i++)
 		m_features[i] = false;
+	m_onRails = false;
 }
 
 DynamicBody::DynamicBody(const Json &jsonObj, Space *space) :
@@ -77,6 +93,7 @@ DynamicBody::DynamicBody(const Json &jsonObj, Space *space) :
 	m_decelerating = false;
 	for (int i = 0; i < Feature::MAX_FEATURE; i++)
 		m_features[i] = false;
+	m_onRails = false;
 }
 
 void DynamicBody::SaveToJson(Json &jsonObj, Space *space)
@@ -239,7 +256,8 @@ void DynamicBody::CalcExternalForce()
 		vector3d fAtmoForce = CalcAtmosphericForce();
 
 		// make this a bit less daft at high time accel
-		// only allow atmosForce to increase by .1g per frame
+		// only allow atmosForce to increase by .1g per integration step,
+		// which is a substep when the tick is split, see CalcSubsteps
 		// TODO: clamp fAtmoForce instead.
 		vector3d f1g = m_atmosForce + fAtmoForce.NormalizedSafe() * GetMass();
 		if (fAtmoForce.LengthSqr() > f1g.LengthSqr())
@@ -259,13 +277,100 @@ void DynamicBody::CalcExternalForce()
 	}
 }
 
+bool DynamicBody::UpdateOnRails(const float timeStep)
+{
+	Frame *f = Frame::GetFrame(GetFrame());
+	Body *body = f ? f->GetBody() : nullptr;
+
+	// only pure gravity: no thrust, no drag, no fictitious forces
+	const bool coasting = timeStep >= RAILS_MIN_TIMESTEP && m_force.ExactlyEqual(vector3d(0.0)) &&
+		body && !body->IsType(Object::SPACESTATION) && !f->IsRotFrame() && body->GetMass() > 0.0 &&
+		GetPosition().Length() > RAILS_MIN_RADII * body->GetPhysRadius();
+
+	// collisions, frame changes and scripts move bodies behind our back
+	if (m_onRails && (!coasting || !GetPosition().ExactlyEqual(m_railsPos) || !m_vel.ExactlyEqual(m_railsVel)))
+		m_onRails = false;
+	if (!coasting)
+		return false;
+
+	if (!m_onRails) {
+		Orbit orbit = Orbit::FromBodyState(GetPosition(), m_vel, body->GetMass());
+		// FromBodyState fudges degenerate and near-parabolic orbits, only
+		// take over if the orbit actually passes through the current state
+		const double posErr = (orbit.OrbitalPosAtTime(0.0) - GetPosition()).Length();
+		const double velErr = (orbit.OrbitalVelocityAtTime(body->GetMass(), 0.0) - m_vel).Length();
+		if (!(orbit.GetSemiMajorAxis() > 0.0) || !(posErr < 1e-6 * GetPosition().Length()) || !(velErr < 1e-6 * m_vel.Length()))
+			return false;
+
+		m_railsOrbit = orbit;
+		m_railsMass = body->GetMass();
+		m_railsTime = 0.0;
+		m_onRails = true;
+	}
+
+	m_railsTime += timeStep;
+	m_railsPos = m_railsOrbit.OrbitalPosAtTime(m_railsTime);
+	m_railsVel = m_railsOrbit.OrbitalVelocityAtTime(m_railsMass, m_railsTime);
+	m_vel = m_railsVel;
+	SetPosition(m_railsPos);
+	return true;
+}
+
+int DynamicBody::CalcSubsteps(const float timeStep) const
+{
+	Frame *f = Frame::GetFrame(GetFrame());
+	Body *body = f ? f->GetBody() : nullptr;
+	if (!body)
+		return 1;
+
+	const double dist = GetPosition().Length();
+	double maxStep = double(timeStep);
+
+	const double mass = body->GetMass();
+	if (mass > 0.0)
+		maxStep = std::min(maxStep, SUBSTEP_ORBIT_FRACTION * sqrt(dist * dist * dist / (G * mass)));
+
+	// stations have no mass worth mentioning but are just as easy to fly into
+	const double speed = m_vel.Length();
+	const double altitude = dist - body->GetPhysRadius();
+	if (speed > 0.0 && altitude > 0.0)
+		maxStep = std::min(maxStep, SUBSTEP_APPROACH_FRACTION * altitude / speed);
+
+	if (!(maxStep > 0.0))
+		return MAX_SUBSTEPS;
+	return Clamp(int(ceil(double(timeStep) / maxStep)), 1, MAX_SUBSTEPS);
+}
+
+void DynamicBody::IntegrateStep(const double h, const bool updateForces)
+{
+	// thrust is held for the whole tick, gravity and drag follow the body
+	if (updateForces)
+		CalcExternalForce();
+	m_vel += h * (m_force + m_externalForce) * (1.0 / m_mass);
+	SetPosition(GetPosition() + m_vel * h);
+}
+
 void DynamicBody::TimeStepUpdate(const float timeStep)
 {
 	m_oldPos = GetPosition();
 	if (m_isMoving) {
-		m_force += m_externalForce;
-
-		m_vel += double(timeStep) * m_force * (1.0 / m_mass);
+		// the orbit already accounts for gravity
+		const bool onRails = UpdateOnRails(timeStep);
+		vector3d externalForce = m_externalForce;
+		if (!onRails) {
+			const int substeps = CalcSubsteps(timeStep);
+			const double h = double(timeStep) / substeps;
+			externalForce = vector3d(0.0);
+			for (int i = 0; i < substeps; i++) {
+				IntegrateStep(h, i > 0);
+				externalForce += m_externalForce;
+			}
+			// the average over the tick, not just the last substep
+			externalForce *= 1.0 / substeps;
+		}
+		// gravity is counted on rails as well, so GetLastForce() doesn't
+		// depend on which path moved the body
+		m_force += externalForce;
 		m_angVel += double(timeStep) * m_torque * (1.0 / m_angInertia);
 
 		double len = m_angVel.Length();
@@ -276,8 +381,6 @@ void DynamicBody::TimeStepUpdate(const float timeStep)
 		}
 		m_oldAngDisplacement = m_angVel * timeStep;
 
-		SetPosition(GetPosition() + m_vel * double(timeStep));
-
 		//if (this->IsType(Object::PLAYER))
 		//Output("pos = %.1f,%.1f,%.1f, vel = %.1f,%.1f,%.1f, force = %.1f,%.1f,%.1f, external = %.1f,%.1f,%.1f\n",
 		//	pos.x, pos.y, pos.z, m_vel.x, m_vel.y, m_vel.z, m_force.x, m_force.y, m_force.z,
@@ -5,6 +5,7 @@
 #define _DYNAMICBODY_H
 
 #include "ModelBody.h"
+#include "Orbit.h"
 #include "matrix4x4.h"
 #include "vector3.h"
 
@@ -34,6 +35,8 @@ public:
 	void SetMassDistributionFromModel();
 	void SetMoving(bool isMoving) { m_isMoving = isMoving; }
 	bool IsMoving() const { return m_isMoving; }
+	// coasting along an orbit rather than being integrated
+	bool IsOnRails() const { return m_onRails; }
 	virtual double GetMass() const override { return m_mass; } // XXX don't override this
 	virtual void TimeStepUpdate(const float timeStep) override;
 	double CalcAtmosphericDrag(double velSqr, double area, double coeff) const;
@@ -126,6 +129,22 @@ private:
 
 	bool m_features[MAX_FEATURE];
 
+	// Kepler propagation for bodies coasting under the gravity of their frame
+	// at high time acceleration, see TimeStepUpdate
+	bool UpdateOnRails(float timeStep);
+
+	bool m_onRails;
+	Orbit m_railsOrbit;
+	double m_railsTime;		// time since m_railsOrbit was fitted
+	double m_railsMass;		// mass of the body being orbited
+	vector3d m_railsPos;	// state left by the last rails step, anything else
+	vector3d m_railsVel;	// moved the body and the orbit no longer applies
+
+	// number of integration steps to split a tick into, so long ticks at
+	// time acceleration stay stable close to planets and stations
+	int CalcSubsteps(float timeStep) const;
+	void IntegrateStep(double h, bool updateForces);
+
 	RefCountedPtr<Propulsion> m_propulsion;
 	RefCountedPtr<FixedGuns> m_fixedGuns;
 };
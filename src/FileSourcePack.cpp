@@ -0,0 +1,198 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "FileSourcePack.h"
+#include "core/LZ4Format.h"
+#include "profiler/Profiler.h"
+#include "utils.h"
+#include <SDL_endian.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace FileSystem {
+
+	static bool seek_to(FILE *file, Uint64 offset)
+	{
+#ifdef _MSC_VER
+		return _fseeki64(file, Sint64(offset), SEEK_SET) == 0;
+#else
+		return fseeko(file, off_t(offset), SEEK_SET) == 0;
+#endif
+	}
+
+	template <typename T>
+	static bool read_array(FILE *file, std::vector<T> &out, size_t count)
+	{
+		out.resize(count);
+		return count == 0 || fread(out.data(), sizeof(T), count, file) == count;
+	}
+
+	FileSourcePack::FileSourcePack(FileSourceFS &fs, const std::string &packPath) :
+		FileSource(packPath),
+		m_file(nullptr)
+	{
+		PROFILE_SCOPED()
+		m_file = fs.OpenReadStream(packPath);
+		if (!m_file) {
+			Output("FileSourcePack: unable to open '%s'\n", packPath.c_str());
+			return;
+		}
+
+		Pack::Header header;
+		if (fread(&header, sizeof(header), 1, m_file) != 1 ||
+			memcmp(header.magic, Pack::MAGIC, sizeof(header.magic)) != 0) {
+			Output("FileSourcePack: '%s' is not a data pack\n", packPath.c_str());
+			Close();
+			return;
+		}
+
+		header.version = SDL_SwapLE32(header.version);
+		header.numEntries = SDL_SwapLE32(header.numEntries);
+		header.numBuckets = SDL_SwapLE32(header.numBuckets);
+		header.namesSize = SDL_SwapLE32(header.namesSize);
+
+		if (header.version != Pack::VERSION) {
+			Output("FileSourcePack: '%s' has unsupported version %u\n", packPath.c_str(), header.version);
+			Close();
+			return;
+		}
+
+		if (header.numEntries == 0 || header.numBuckets == 0 || (header.numBuckets & (header.numBuckets - 1)) != 0 ||
+			!read_array(m_file, m_entries, header.numEntries) ||
+			!read_array(m_file, m_buckets, header.numBuckets) ||
+			!read_array(m_file, m_names, header.namesSize) ||
+			m_names.empty() || m_names.back() != '\0') {
+			Output("FileSourcePack: '%s' has a corrupt index\n", packPath.c_str());
+			Close();
+			return;
+		}
+
+		for (Pack::Entry &e : m_entries) {
+			e.hash = SDL_SwapLE64(e.hash);
+			e.offset = SDL_SwapLE64(e.offset);
+			e.size = SDL_SwapLE64(e.size);
+			e.packedSize = SDL_SwapLE64(e.packedSize);
+			e.nameOffset = SDL_SwapLE32(e.nameOffset);
+			if (e.nameOffset >= header.namesSize ||
+				(e.type == Pack::ENTRY_DIR && e.offset + e.size > header.numEntries)) {
+				Output("FileSourcePack: '%s' has a corrupt entry\n", packPath.c_str());
+				Close();
+				return;
+			}
+		}
+		for (Uint32 &b : m_buckets)
+			b = SDL_SwapLE32(b);
+	}
+
+	FileSourcePack::~FileSourcePack()
+	{
+		Close();
+	}
+
+	void FileSourcePack::Close()
+	{
+		if (m_file) fclose(m_file);
+		m_file = nullptr;
+		m_entries.clear();
+		m_buckets.clear();
+		m_names.clear();
+	}
+
+	Uint32 FileSourcePack::FindEntry(const std::string &path) const
+	{
+		if (m_buckets.empty())
+			return Pack::EMPTY_BUCKET;
+
+		// paths in the pack are stored normalised and relative to its root
+		std::string name;
+		try {
+			const size_t start = path.find_first_not_of('/');
+			name = NormalisePath(start == std::string::npos ? std::string() : path.substr(start));
+		} catch (std::invalid_argument &) {
+			return Pack::EMPTY_BUCKET;
+		}
+
+		const Uint64 hash = Pack::HashPath(name);
+		const Uint32 mask = Uint32(m_buckets.size() - 1);
+		for (Uint32 slot = Uint32(hash) & mask;; slot = (slot + 1) & mask) {
+			const Uint32 index = m_buckets[slot];
+			if (index == Pack::EMPTY_BUCKET || index >= m_entries.size())
+				return Pack::EMPTY_BUCKET;
+			const Pack::Entry &e = m_entries[index];
+			if (e.hash == hash && name == &m_names[e.nameOffset])
+				return index;
+		}
+	}
+
+	FileInfo FileSourcePack::MakeEntryInfo(Uint32 index)
+	{
+		const Pack::Entry &e = m_entries[index];
+		return MakeFileInfo(&m_names[e.nameOffset], e.type == Pack::ENTRY_DIR ? FileInfo::FT_DIR : FileInfo::FT_FILE);
+	}
+
+	FileInfo FileSourcePack::Lookup(const std::string &path)
+	{
+		const Uint32 index = FindEntry(path);
+		if (index == Pack::EMPTY_BUCKET)
+			return MakeFileInfo(path, FileInfo::FT_NON_EXISTENT);
+		return MakeEntryInfo(index);
+	}
+
+	RefCountedPtr<FileData> FileSourcePack::ReadFile(const std::string &path)
+	{
+		PROFILE_SCOPED()
+		const Uint32 index = FindEntry(path);
+		if (index == Pack::EMPTY_BUCKET || m_entries[index].type != Pack::ENTRY_FILE)
+			return RefCountedPtr<FileData>();
+
+		const Pack::Entry &e = m_entries[index];
+		const size_t size = size_t(e.size);
+		const size_t packedSize = size_t(e.packedSize);
+
+		char *data = static_cast<char *>(std::malloc(packedSize ? packedSize : 1));
+		{
+			std::lock_guard<std::mutex> lock(m_fileLock);
+			if (!seek_to(m_file, e.offset) || fread(data, 1, packedSize, m_file) != packedSize) {
+				Output("FileSourcePack::ReadFile: couldn't read '%s'\n", path.c_str());
+				std::free(data);
+				return RefCountedPtr<FileData>();
+			}
+		}
+
+		if (e.compression == Pack::COMPRESS_LZ4) {
+			std::string plain;
+			try {
+				plain = lz4::DecompressLZ4(lz4::string_view(data, packedSize));
+			} catch (lz4::DecompressionFailedException &ex) {
+				Output("FileSourcePack::ReadFile: couldn't decompress '%s': %s\n", path.c_str(), ex.what());
+			}
+			std::free(data);
+			if (plain.size() != size)
+				return RefCountedPtr<FileData>();
+
+			data = static_cast<char *>(std::malloc(size ? size : 1));
+			memcpy(data, plain.data(), size);
+		}
+
+		return RefCountedPtr<FileData>(new FileDataMalloc(MakeEntryInfo(index), size, data));
+	}
+
+	bool FileSourcePack::ReadDirectory(const std::string &path, std::vector<FileInfo> &output)
+	{
+		const Uint32 index = FindEntry(path);
+		if (index == Pack::EMPTY_BUCKET || m_entries[index].type != Pack::ENTRY_DIR)
+			return false;
+
+		// children are stored contiguously and in sorted order
+		const Pack::Entry &dir = m_entries[index];
+		const Uint32 first = Uint32(dir.offset);
+		const Uint32 count = Uint32(dir.size);
+		output.reserve(output.size() + count);
+		for (Uint32 i = first; i < first + count; i++)
+			output.push_back(MakeEntryInfo(i));
+
+		return true;
+	}
+
+} // namespace FileSystem
@@ -0,0 +1,126 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _FILESOURCEPACK_H
+#define _FILESOURCEPACK_H
+
+#include "FileSystem.h"
+#include <SDL_stdinc.h>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * A packed data archive (.pak), built from a data directory by the packdata tool.
+ *
+ * Layout (all integers little-endian):
+ *   PackHeader
+ *   PackEntry[numEntries]    - one per file or directory, root directory first.
+ *                              the children of a directory are stored contiguously
+ *                              and sorted by path, so a directory listing is a slice.
+ *   Uint32[numBuckets]       - open-addressed hash index into the entry table,
+ *                              keyed on HashPath(path), PACK_EMPTY_BUCKET if unused
+ *   char[namesSize]          - NUL-terminated entry paths
+ *   file data                - stored raw or as an LZ4 frame
+ *
+ * The whole index is read once when the archive is opened, after that lookups
+ * and directory listings never touch the disk.
+ */
+
+namespace FileSystem {
+
+	namespace Pack {
+		static const char MAGIC[4] = { 'P', 'P', 'A', 'K' };
+		static const Uint32 VERSION = 1;
+		static const Uint32 EMPTY_BUCKET = Uint32(-1);
+
+		enum Compression {
+			COMPRESS_NONE = 0,
+			COMPRESS_LZ4 = 1
+		};
+
+		enum EntryType {
+			ENTRY_DIR = 0,
+			ENTRY_FILE = 1
+		};
+
+		struct Header {
+			char magic[4];
+			Uint32 version;
+			Uint32 numEntries;
+			Uint32 numBuckets; // always a power of two
+			Uint32 namesSize;
+			Uint32 reserved;
+		};
+
+		struct Entry {
+			Uint64 hash;
+			// files: absolute offset of the data in the archive
+			// directories: index of the first child entry
+			Uint64 offset;
+			// files: uncompressed size; directories: number of children
+			Uint64 size;
+			// files: size of the data as stored in the archive
+			Uint64 packedSize;
+			Uint32 nameOffset;
+			Uint8 type;
+			Uint8 compression;
+			Uint16 reserved;
+		};
+
+		static_assert(sizeof(Header) == 24, "pack header must not be padded");
+		static_assert(sizeof(Entry) == 40, "pack entry must not be padded");
+
+		// 64-bit FNV-1a over a normalised path
+		inline Uint64 HashPath(const char *path, size_t len)
+		{
+			Uint64 h = 14695981039346656037ULL;
+			for (size_t i = 0; i < len; i++) {
+				h ^= Uint8(path[i]);
+				h *= 1099511628211ULL;
+			}
+			return h;
+		}
+		inline Uint64 HashPath(const std::string &path) { return HashPath(path.c_str(), path.size()); }
+
+		// smallest power of two bucket count that keeps the index at most half full
+		inline Uint32 BucketCount(Uint32 numEntries)
+		{
+			Uint32 n = 16;
+			while (n < numEntries * 2)
+				n <<= 1;
+			return n;
+		}
+	} // namespace Pack
+
+	class FileSourcePack : public FileSource {
+	public:
+		// like FileSourceZip, this needs stream access to the archive
+		FileSourcePack(FileSourceFS &fs, const std::string &packPath);
+		virtual ~FileSourcePack();
+
+		bool IsOpen() const { return m_file != nullptr; }
+		size_t GetEntryCount() const { return m_entries.size(); }
+
+		virtual FileInfo Lookup(const std::string &path);
+		virtual RefCountedPtr<FileData> ReadFile(const std::string &path);
+		virtual bool ReadDirectory(const std::string &path, std::vector<FileInfo> &output);
+
+	private:
+		// returns the entry index for path, or EMPTY_BUCKET
+		Uint32 FindEntry(const std::string &path) const;
+		FileInfo MakeEntryInfo(Uint32 index);
+		void Close();
+
+		FILE *m_file;
+		std::mutex m_fileLock;
+
+		std::vector<Pack::Entry> m_entries;
+		std::vector<Uint32> m_buckets;
+		std::vector<char> m_names;
+	};
+
+} // namespace FileSystem
+
+#endif
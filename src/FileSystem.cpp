@@ -2,8 +2,10 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "FileSystem.h"
+#include "FileSourcePack.h"
 #include "StringRange.h"
 #include "libs.h"
+#include "utils.h"
 #include <algorithm>
 #include <cassert>
 #include <iterator>
@@ -185,14 +187,41 @@ namespace FileSystem {
 		return true;
 	}
 
+	// packed copy of the app data, built by the packdata tool
+	static const char *const DATA_PACK_NAME = "data.pak";
+	static std::unique_ptr<FileSourcePack> dataFilesPack;
+
 	void Init()
 	{
 		gameDataFiles.AppendSource(&dataFilesUser);
+
+		// an installed pack replaces the loose app data, so that lookups
+		// never fall through to the disk. loose files in the user data dir
+		// still override it
+		if (dataFilesApp.Lookup(DATA_PACK_NAME).IsFile()) {
+			dataFilesPack.reset(new FileSourcePack(dataFilesApp, DATA_PACK_NAME));
+			if (dataFilesPack->IsOpen()) {
+				gameDataFiles.AppendSource(dataFilesPack.get());
+				return;
+			}
+			Output("FileSystem: couldn't open %s, using the loose data files\n", DATA_PACK_NAME);
+			dataFilesPack.reset();
+		}
+
 		gameDataFiles.AppendSource(&dataFilesApp);
 	}
 
+	std::string GetDataWriteDir()
+	{
+		return dataFilesPack ? dataFilesUser.GetRoot() : GetDataDir();
+	}
+
 	void Uninit()
 	{
+		if (dataFilesPack) {
+			gameDataFiles.RemoveSource(dataFilesPack.get());
+			dataFilesPack.reset();
+		}
 	}
 
 	FileInfo::FileInfo(FileSource *source, const std::string &path, FileType type, Time::DateTime modTime) :
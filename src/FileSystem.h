@@ -39,6 +39,11 @@ namespace FileSystem {
 	std::string GetUserDir();
 	std::string GetDataDir();
 
+	/// Where tools that generate game data should write it: the data dir,
+	/// unless that holds a mounted data pack, whose loose files are never read.
+	/// Then it is the user data dir, which overrides the pack
+	std::string GetDataWriteDir();
+
 	/// Makes a string safe for use as a file name
 	/// warning: this mapping is non-injective, that is,
 	/// multiple input names may produce the same output
@@ -2,7 +2,6 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "FixedGuns.h"
-#include "Beam.h"
 #include "DynamicBody.h"
 #include "GameSaveError.h"
 #include "Projectile.h"
@@ -189,10 +188,10 @@ bool FixedGuns::Fire(const int num, Body *b)
 		const vector3d pos = b->GetOrient() * vector3d(m_gun[num].locs[iBarrel].pos) + b->GetPosition();
 
 		if (m_gun[num].projData.beam) {
-			Beam::Add(b, m_gun[num].projData, pos, b->GetVelocity(), dir);
+			ProjectileManager::AddBeam(b, m_gun[num].projData, pos, b->GetVelocity(), dir);
 		} else {
 			const vector3d dirVel = m_gun[num].projData.speed * dir;
-			Projectile::Add(b, m_gun[num].projData, pos, b->GetVelocity(), dirVel);
+			ProjectileManager::AddBolt(b, m_gun[num].projData, pos, b->GetVelocity(), dirVel);
 		}
 	}
 
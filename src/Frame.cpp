@@ -13,6 +13,28 @@
 std::vector<Frame> Frame::s_frames;
 std::vector<CollisionSpace> Frame::s_collisionSpaces;
 
+namespace {
+	// direct-mapped on (frame, relTo). an entry is valid while its generation
+	// matches the current one; generations are drawn from a single counter so
+	// they are never reused
+	struct CachedTransform {
+		FrameId from, relTo;
+		Uint64 generation;
+		Frame::RelTransform transform;
+	};
+	const size_t TRANSFORM_CACHE_SIZE = 256;
+	CachedTransform s_transformCache[TRANSFORM_CACHE_SIZE];
+	CachedTransform s_interpTransformCache[TRANSFORM_CACHE_SIZE];
+	Uint64 s_lastGeneration = 1;
+	Uint64 s_transformGeneration = 1;
+	Uint64 s_interpGeneration = 1;
+} // namespace
+
+static inline size_t transform_cache_slot(FrameId from, FrameId relTo)
+{
+	return ((from.id() * 0x9E3779B1u) ^ relTo.id()) & (TRANSFORM_CACHE_SIZE - 1);
+}
+
 Frame::Frame(const Dummy &d, FrameId parent, const char *label, unsigned int flags, double radius) :
 	m_parent(parent),
 	m_sbody(nullptr),
@@ -235,6 +257,7 @@ void Frame::DeleteFrames()
 	});
 	// then delete it
 	s_frames.clear();
+	InvalidateTransforms();
 
 	// remember to delete CollisionSpaces
 	s_collisionSpaces.clear();
@@ -281,6 +304,7 @@ void Frame::DeleteCameraFrame(FrameId camera)
 #endif // NDEBUG
 	s_frames.back().d.madeWithFactory = true;
 	s_frames.pop_back();
+	InvalidateTransforms();
 }
 
 void Frame::PostUnserializeFixup(FrameId fId, Space *space)
@@ -430,6 +454,7 @@ matrix4x4d Frame::GetInterpTransformRelTo(FrameId relToId) const
 void Frame::UpdateInterpTransform(double alpha)
 {
 	PROFILE_SCOPED()
+	s_interpGeneration = ++s_lastGeneration;
 	m_interpPos = alpha * m_pos + (1.0 - alpha) * m_oldPos;
 
 	double len = m_oldAngDisplacement * (1.0 - alpha);
@@ -455,10 +480,42 @@ void Frame::UpdateInterpTransform(double alpha)
 
 void Frame::GetFrameTransform(const FrameId fFromId, const FrameId fToId, matrix4x4d &m)
 {
-	matrix3x3d forient = Frame::GetFrame(fFromId)->GetOrientRelTo(fToId);
-	vector3d fpos = Frame::GetFrame(fFromId)->GetPositionRelTo(fToId);
-	m = forient;
-	m.SetTranslate(fpos);
+	const RelTransform t = Frame::GetFrame(fFromId)->GetCachedTransformRelTo(fToId);
+	m = t.orient;
+	m.SetTranslate(t.pos);
+}
+
+void Frame::InvalidateTransforms()
+{
+	s_transformGeneration = s_interpGeneration = ++s_lastGeneration;
+}
+
+Frame::RelTransform Frame::GetCachedTransformRelTo(FrameId relToId) const
+{
+	CachedTransform &c = s_transformCache[transform_cache_slot(m_thisId, relToId)];
+	if (c.generation != s_transformGeneration || c.from != m_thisId || c.relTo != relToId) {
+		c.from = m_thisId;
+		c.relTo = relToId;
+		c.generation = s_transformGeneration;
+		c.transform.orient = GetOrientRelTo(relToId);
+		c.transform.pos = GetPositionRelTo(relToId);
+		c.transform.vel = GetVelocityRelTo(relToId);
+	}
+	return c.transform;
+}
+
+Frame::RelTransform Frame::GetCachedInterpTransformRelTo(FrameId relToId) const
+{
+	CachedTransform &c = s_interpTransformCache[transform_cache_slot(m_thisId, relToId)];
+	if (c.generation != s_interpGeneration || c.from != m_thisId || c.relTo != relToId) {
+		c.from = m_thisId;
+		c.relTo = relToId;
+		c.generation = s_interpGeneration;
+		c.transform.orient = GetInterpOrientRelTo(relToId);
+		c.transform.pos = GetInterpPositionRelTo(relToId);
+		c.transform.vel = vector3d(0.0);
+	}
+	return c.transform;
 }
 
 void Frame::ClearMovement()
@@ -505,6 +562,7 @@ void Frame::UpdateOrbitRails(double time, double timestep)
 
 void Frame::SetInitialOrient(const matrix3x3d &m, double time)
 {
+	InvalidateTransforms();
 	m_initialOrient = m;
 	double ang = fmod(m_angSpeed * time, 2.0 * M_PI);
 	if (!is_zero_exact(ang)) {						// frequently used with e^-10 etc
@@ -517,6 +575,7 @@ void Frame::SetInitialOrient(const matrix3x3d &m, double time)
 
 void Frame::SetOrient(const matrix3x3d &m, double time)
 {
+	InvalidateTransforms();
 	m_orient = m;
 	double ang = fmod(m_angSpeed * time, 2.0 * M_PI);
 	if (!is_zero_exact(ang)) {					   // frequently used with e^-10 etc
@@ -529,6 +588,8 @@ void Frame::SetOrient(const matrix3x3d &m, double time)
 
 void Frame::UpdateRootRelativeVars()
 {
+	InvalidateTransforms();
+
 	// update pos & vel relative to parent frame
 	Frame *parent = Frame::GetFrame(m_parent);
 	if (!parent) {
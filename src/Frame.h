@@ -66,13 +66,21 @@ public:
 	const std::string &GetLabel() const { return m_label; }
 	void SetLabel(const char *label) { m_label = label; }
 
-	void SetPosition(const vector3d &pos) { m_pos = pos; }
+	void SetPosition(const vector3d &pos)
+	{
+		m_pos = pos;
+		InvalidateTransforms();
+	}
 	vector3d GetPosition() const { return m_pos; }
 	void SetInitialOrient(const matrix3x3d &m, double time);
 	void SetOrient(const matrix3x3d &m, double time);
 	const matrix3x3d &GetOrient() const { return m_orient; }
 	const matrix3x3d &GetInterpOrient() const { return m_interpOrient; }
-	void SetVelocity(const vector3d &vel) { m_vel = vel; }
+	void SetVelocity(const vector3d &vel)
+	{
+		m_vel = vel;
+		InvalidateTransforms();
+	}
 	vector3d GetVelocity() const { return m_vel; }
 	void SetAngSpeed(const double angspeed) { m_angSpeed = angspeed; }
 	double GetAngSpeed() const { return m_angSpeed; }
@@ -130,6 +138,17 @@ public:
 
 	static void GetFrameTransform(FrameId fFrom, FrameId fTo, matrix4x4d &m);
 
+	// The above, composed once and cached until any frame moves, which in
+	// practice means once per physics tick (or per render frame for the
+	// interpolated version). Body uses these for its *RelTo queries.
+	struct RelTransform {
+		matrix3x3d orient;
+		vector3d pos;
+		vector3d vel; // not filled in for the interpolated transform
+	};
+	RelTransform GetCachedTransformRelTo(FrameId relTo) const;
+	RelTransform GetCachedInterpTransformRelTo(FrameId relTo) const;
+
 	std::unique_ptr<SfxManager> m_sfx; // the last survivor. actually m_children is pretty grim too.
 
 private:
@@ -137,6 +156,9 @@ private:
 
 	void UpdateRootRelativeVars();
 
+	// drops every cached RelTransform, called whenever a frame moves
+	static void InvalidateTransforms();
+
 	FrameId m_parent;				 // if parent is null then frame position is absolute
 	std::vector<FrameId> m_children; // child frames, first may be rotating
 	SystemBody *m_sbody;			 // points to SBodies in Pi::current_system
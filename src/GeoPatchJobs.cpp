@@ -91,6 +91,7 @@ void SinglePatchJob::OnFinish() // runs in primary thread of the context
 
 void SinglePatchJob::OnRun() // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
 {
+	PROFILE_SCOPED()
 	BasePatchJob::OnRun();
 
 	const SSingleSplitRequest &srd = *mData;
@@ -128,6 +129,7 @@ void QuadPatchJob::OnFinish() // runs in primary thread of the context
 
 void QuadPatchJob::OnRun() // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
 {
+	PROFILE_SCOPED()
 	BasePatchJob::OnRun();
 
 	const SQuadSplitRequest &srd = *mData;
@@ -312,6 +312,7 @@ int AsyncJobQueue::JobRunner::Trampoline(void *data)
 
 void AsyncJobQueue::JobRunner::Main()
 {
+	PROFILE_THREAD_NAME(m_threadName.c_str())
 	Job *job;
 
 	// Lock to prevent destruction of the queue while calling GetJob.
@@ -330,7 +331,10 @@ void AsyncJobQueue::JobRunner::Main()
 		SDL_UnlockMutex(m_jobLock);
 
 		// run the thing
-		job->OnRun();
+		{
+			PROFILE_SCOPED_RAW("Job::OnRun")
+			job->OnRun();
+		}
 
 		// Lock to prevent destruction of the queue while calling Finish
 		SDL_LockMutex(m_queueDestroyingLock);
@@ -115,7 +115,7 @@ void Missile::StaticUpdate(const float timeStep)
 	if (!m_curAICmd) {
 		GetPropulsion()->ClearLinThrusterState();
 		GetPropulsion()->ClearAngThrusterState();
-	} else if (m_curAICmd->TimeStepUpdate()) {
+	} else if (m_curAICmd->TimeStepUpdate(timeStep)) {
 		delete m_curAICmd;
 		m_curAICmd = nullptr;
 	}
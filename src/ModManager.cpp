@@ -2,6 +2,7 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "ModManager.h"
+#include "FileSourcePack.h"
 #include "FileSourceZip.h"
 #include "FileSystem.h"
 #include "utils.h"
@@ -16,6 +17,9 @@ void ModManager::Init()
 		if (ends_with_ci(zipPath, ".zip")) {
 			Output("adding mod: %s\n", zipPath.c_str());
 			FileSystem::gameDataFiles.PrependSource(new FileSystem::FileSourceZip(FileSystem::userFiles, zipPath));
+		} else if (ends_with_ci(zipPath, ".pak")) {
+			Output("adding mod: %s\n", zipPath.c_str());
+			FileSystem::gameDataFiles.PrependSource(new FileSystem::FileSourcePack(FileSystem::userFiles, zipPath));
 		}
 	}
 }
@@ -22,7 +22,6 @@ public:
 		STAR,
 		CARGOBODY,
 		CITYONPLANET, // <enum skip>
-		PROJECTILE, // <enum skip>
 		MISSILE,
 		HYPERSPACECLOUD // <enum skip>
 	};
@@ -26,18 +26,19 @@
 #include "core/GuiApplication.h"
 #include "core/Log.h"
 #include "core/OS.h"
+#include "graphics/dummy/RendererDummy.h"
 #include "graphics/opengl/RendererGL.h"
 #include "lua/Lua.h"
 #include "lua/LuaConsole.h"
 #include "lua/LuaEvent.h"
 #include "lua/LuaPiGui.h"
 #include "lua/LuaTimer.h"
+#include "lua/PropertyMap.h"
 #include "profiler/Profiler.h"
 #include "sound/AmbientSounds.h"
 #if WITH_OBJECTVIEWER
 #include "ObjectViewerView.h"
 #endif
-#include "Beam.h"
 #include "Player.h"
 #include "PngWriter.h"
 #include "Projectile.h"
@@ -121,6 +122,7 @@ std::string Pi::profilerPath;
 std::string Pi::profileOnePath;
 bool Pi::doProfileSlow = false;
 bool Pi::doProfileOne = false;
+int Pi::traceFrames = 0;
 #endif
 int Pi::statSceneTris = 0;
 int Pi::statNumPatches = 0;
@@ -212,6 +214,8 @@ protected:
 	void InitGame();
 	void EndGame();
 
+	void RunPhysicsTicks(float step);
+
 	double time_player_died;
 
 	// Used to measure frame and physics performance timing info
@@ -226,8 +230,14 @@ protected:
 	int phys_stat;
 
 	int MAX_PHYSICS_TICKS;
+	int phys_ticks;
 	double accumulator;
 
+	// run the next frame's physics ticks once this frame has been submitted,
+	// so they overlap with the GPU drawing it instead of waiting for it
+	bool pipeline_physics;
+	double predicted_time; // game time already simulated ahead of the next frame
+
 	Uint32 last_stats = SDL_GetTicks();
 };
 
@@ -268,6 +278,11 @@ void Pi::App::SetStartPath(const SystemPath &startPath)
 	static_cast<MainMenu *>(m_mainMenu.get())->SetStartPath(startPath);
 }
 
+void Pi::App::SetBenchmark(std::shared_ptr<Lifecycle> benchmark)
+{
+	m_benchmark = benchmark;
+}
+
 void Pi::RequestProfileFrame(const std::string &profilePath)
 {
 // don't do anything if we're building without profiler.
@@ -281,8 +296,24 @@ void Pi::RequestProfileFrame(const std::string &profilePath)
 #endif
 }
 
+void Pi::RequestTraceFrames(int numFrames)
+{
+#ifdef PIONEER_PROFILER
+	if (Profiler::tracing() || numFrames <= 0)
+		return;
+
+	Output("tracing the next %d frames\n", numFrames);
+	traceFrames = numFrames;
+	Profiler::tracestart();
+#endif
+}
+
 void TestGPUJobsSupport()
 {
+	// the shaders can't be tested without a real renderer
+	if (Pi::renderer->GetRendererType() == Graphics::RENDERER_DUMMY)
+		return;
+
 	bool supportsGPUJobs = (Pi::config->Int("EnableGPUJobs") == 1);
 	if (supportsGPUJobs) {
 		Uint32 octaves = 8;
@@ -372,6 +403,7 @@ void Pi::App::Startup()
 	Pi::detail.cities = config->Int("DetailCities");
 
 	Graphics::RendererOGL::RegisterRenderer();
+	Graphics::RendererDummy::RegisterRenderer();
 	Pi::renderer = StartupRenderer(Pi::config);
 
 	Pi::rng.IncRefCount(); // so nothing tries to free it
@@ -412,7 +444,9 @@ void Pi::App::Startup()
 	QueueLifecycle(m_loader);
 
 	// Don't start the main menu if we don't have a GUI
-	if (!m_noGui)
+	if (m_benchmark)
+		QueueLifecycle(m_benchmark);
+	else if (!m_noGui)
 		QueueLifecycle(m_mainMenu);
 
 	startupTimer.Stop();
@@ -442,8 +476,7 @@ void Pi::App::Shutdown()
 	// TODO: connect initializers and deinitializers in a single Module interface
 	// Will need to think about dependency injection for e.g. modules which need a
 	// reference to the renderer
-	Projectile::FreeModel();
-	Beam::FreeModel();
+	ProjectileManager::FreeModel();
 	delete Pi::intro;
 	delete Pi::luaConsole;
 	NavLights::Uninit();
@@ -765,7 +798,9 @@ void Pi::HandleKeyDown(SDL_Keysym *key)
 #if WITH_DEVKEYS
 #ifdef PIONEER_PROFILER
 	case SDLK_p: // alert it that we want to profile
-		if (input->KeyState(SDLK_LSHIFT) || input->KeyState(SDLK_RSHIFT))
+		if (input->KeyState(SDLK_LALT) || input->KeyState(SDLK_RALT))
+			Pi::RequestTraceFrames(120);
+		else if (input->KeyState(SDLK_LSHIFT) || input->KeyState(SDLK_RSHIFT))
 			Pi::doProfileOne = true;
 		else {
 			Pi::doProfileSlow = !Pi::doProfileSlow;
@@ -926,12 +961,26 @@ void Pi::App::PreUpdate()
 	GuiApplication::PreUpdate();
 }
 
+// per-frame time allowed for Lua garbage collection
+static float GetLuaGCBudget()
+{
+	// nothing much else is happening in menus or while paused
+	if (!Pi::game || Pi::game->IsPaused() || !Pi::player)
+		return 4.0f;
+	if (Pi::player->GetAlertState() == Ship::ALERT_SHIP_FIRING)
+		return 0.5f;
+	return 1.0f;
+}
+
 void Pi::App::PostUpdate()
 {
 	GuiApplication::PostUpdate();
 
 	HandleRequests();
 
+	if (Lua::manager)
+		Lua::manager->StepGarbageCollector(GetLuaGCBudget());
+
 #ifdef PIONEER_PROFILER
 	// TODO: profileSlow is profiling the previous frame, need to move that functionality to Application
 	if (Pi::doProfileOne || (Pi::doProfileSlow && (GetFrameTime() > 0.1))) { // slow: < ~10fps
@@ -943,6 +992,17 @@ void Pi::App::PostUpdate()
 			Profiler::dumphtml(Pi::profilerPath.c_str());
 		}
 	}
+
+	if (Pi::traceFrames > 0 && --Pi::traceFrames == 0) {
+		char buf[64];
+		const time_t t = time(0);
+		strftime(buf, sizeof(buf), "trace-%Y%m%d-%H%M%S.json", localtime(&t));
+		const std::string tracePath = FileSystem::JoinPathBelow(Pi::profilerPath, buf);
+		if (Profiler::tracewrite(tracePath.c_str()))
+			Output("trace written to %s\n", tracePath.c_str());
+		else
+			Output("couldn't write trace to %s\n", tracePath.c_str());
+	}
 #endif
 }
 
@@ -993,6 +1053,9 @@ void GameLoop::Start()
 	if (MAX_PHYSICS_TICKS <= 0)
 		MAX_PHYSICS_TICKS = 4;
 
+	pipeline_physics = Pi::config->Int("PipelinePhysics") != 0;
+	predicted_time = 0.0;
+
 	Pi::SetGameTickAlpha(0);
 	// If we have a tombstone loop, we will SetNextLifecycle() so it runs before
 	// we jump back to the main menu
@@ -1015,22 +1078,19 @@ void GameLoop::Update(float deltaTime)
 	// if (Pi::frameTime > 0.25) Pi::frameTime = 0.25;
 
 	accumulator += deltaTime * Pi::game->GetTimeAccelRate();
+	phys_ticks = 0;
 
 	const float step = Pi::game->GetTimeStep();
+	if (predicted_time > 0.0) {
+		// the end of the last frame guessed this frame would be as long as that one.
+		// if it was shorter the extra time is paid back next frame, up to one tick
+		accumulator = std::max(accumulator - predicted_time, -double(step));
+		predicted_time = 0.0;
+	}
+
 	if (step > 0.0f) {
 		PROFILE_SCOPED_RAW("Physics Update [unpaused]")
-		int phys_ticks = 0;
-		while (accumulator >= step) {
-			if (++phys_ticks >= MAX_PHYSICS_TICKS) {
-				accumulator = 0.0;
-				break;
-			}
-
-			Pi::game->TimeStep(step);
-			BaseSphere::UpdateAllBaseSphereDerivatives();
-
-			accumulator -= step;
-		}
+		RunPhysicsTicks(step);
 
 		// rendering interpolation between frames: don't use when docked
 		// FIXME: this is the player's concern, the player should be responsible for calling Pi::SetInterpolation(false) when docked
@@ -1038,15 +1098,16 @@ void GameLoop::Update(float deltaTime)
 		if (pstate == Ship::DOCKED || pstate == Ship::DOCKING || pstate == Ship::UNDOCKING)
 			Pi::SetGameTickAlpha(1.0);
 		else
-			Pi::SetGameTickAlpha(accumulator / step);
-
-		phys_stat += phys_ticks;
+			Pi::SetGameTickAlpha(std::max(accumulator, 0.0) / step);
 	} else {
 		// paused
 		PROFILE_SCOPED_RAW("Physics Update [paused]")
 		BaseSphere::UpdateAllBaseSphereDerivatives();
 	}
 
+	// property changes made by the physics ticks go out once per frame
+	PropertyMap::EmitPendingSignals();
+
 	// Record physics timestep but keep information about current frame timing.
 	perfTimer.SoftStop();
 	// store the physics time until the end of the frame
@@ -1150,6 +1211,21 @@ void GameLoop::Update(float deltaTime)
 
 	Pi::GetApp()->RunJobs();
 
+	// everything that reads the game state this frame is done: get the GPU going
+	// on the frame and simulate the next one while it draws
+	if (pipeline_physics && Pi::game->GetTimeStep() > 0.0f) {
+		PROFILE_SCOPED_RAW("Physics Update [pipelined]")
+		Pi::renderer->FlushCommandBuffers();
+
+		perfTimer.SoftReset();
+		predicted_time = deltaTime * Pi::game->GetTimeAccelRate();
+		accumulator += predicted_time;
+		RunPhysicsTicks(Pi::game->GetTimeStep());
+		perfTimer.SoftStop();
+		phys_time += perfTimer.milliseconds();
+	}
+	phys_stat += phys_ticks;
+
 	perfInfoDisplay->Update(frame_time_real, phys_time);
 	if (Pi::showDebugInfo && SDL_GetTicks() - last_stats >= 1000) {
 		perfInfoDisplay->UpdateFrameInfo(frame_stat, phys_stat);
@@ -1173,6 +1249,22 @@ void GameLoop::Update(float deltaTime)
 #endif
 }
 
+// runs physics ticks until the accumulator is drained or this frame's tick budget is spent
+void GameLoop::RunPhysicsTicks(float step)
+{
+	while (accumulator >= step) {
+		if (++phys_ticks >= MAX_PHYSICS_TICKS) {
+			accumulator = 0.0;
+			break;
+		}
+
+		Pi::game->TimeStep(step);
+		BaseSphere::UpdateAllBaseSphereDerivatives();
+
+		accumulator -= step;
+	}
+}
+
 void GameLoop::End()
 {
 	// When Pi::game goes, so too goes the death view.
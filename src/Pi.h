@@ -83,6 +83,9 @@ public:
 
 		void SetStartPath(const SystemPath &startPath);
 
+		// run this after loading instead of the main menu
+		void SetBenchmark(std::shared_ptr<Lifecycle> benchmark);
+
 	protected:
 		// for compatibility, while we're moving Pi's internals into App
 		friend class Pi;
@@ -91,6 +94,7 @@ public:
 		friend class MainMenu;
 		friend class GameLoop;
 		friend class TombstoneLoop;
+		friend class Benchmark;
 
 		App() :
 			GuiApplication("Pioneer") {}
@@ -120,6 +124,7 @@ public:
 		std::shared_ptr<Lifecycle> m_loader;
 		std::shared_ptr<Lifecycle> m_mainMenu;
 		std::shared_ptr<Lifecycle> m_gameLoop;
+		std::shared_ptr<Lifecycle> m_benchmark;
 	};
 
 public:
@@ -203,9 +208,12 @@ public:
 	static std::string profileOnePath;
 	static bool doProfileSlow;
 	static bool doProfileOne;
+	static int traceFrames;
 #endif
 
 	static void RequestProfileFrame(const std::string &profilePath = "");
+	// record a Chrome trace of the next numFrames frames into the profiler directory
+	static void RequestTraceFrames(int numFrames);
 
 	static Input *input;
 	static Player *player;
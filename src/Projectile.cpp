@@ -3,11 +3,13 @@
 
 #include "Projectile.h"
 
+#include "Camera.h"
 #include "CargoBody.h"
 #include "Frame.h"
 #include "Game.h"
 #include "GameSaveError.h"
 #include "Json.h"
+#include "JsonUtils.h"
 #include "Pi.h"
 #include "Planet.h"
 #include "Player.h"
@@ -26,20 +28,46 @@
 #include "lua/LuaEvent.h"
 #include "lua/LuaUtils.h"
 
-std::unique_ptr<Graphics::VertexArray> Projectile::s_sideVerts;
-std::unique_ptr<Graphics::VertexArray> Projectile::s_glowVerts;
-std::unique_ptr<Graphics::Material> Projectile::s_sideMat;
-std::unique_ptr<Graphics::Material> Projectile::s_glowMat;
-Graphics::RenderState *Projectile::s_renderState = nullptr;
+namespace {
+	// laser pulses do not age well!
+	static const float BEAM_LIFETIME = 0.1f;
 
-void Projectile::BuildModel()
+	// camera space geometry of everything drawn this frame, one per material
+	static std::unique_ptr<Graphics::VertexArray> s_boltSideBatch;
+	static std::unique_ptr<Graphics::VertexArray> s_beamSideBatch;
+	static std::unique_ptr<Graphics::VertexArray> s_glowBatch;
+
+	// appends model scaled and rotated onto the axes x, y, z at origin
+	static void AddTransformed(Graphics::VertexArray &batch, const Graphics::VertexArray &model, const vector3f &origin,
+		const vector3f &x, const vector3f &y, const vector3f &z, const Color &color)
+	{
+		for (Uint32 v = 0; v < model.GetNumVerts(); v++) {
+			const vector3f &p = model.position[v];
+			batch.Add(origin + x * p.x + y * p.y + z * p.z, color, model.uv0[v]);
+		}
+	}
+} // namespace
+
+std::unique_ptr<Graphics::VertexArray> ProjectileManager::s_boltSideVerts;
+std::unique_ptr<Graphics::VertexArray> ProjectileManager::s_boltGlowVerts;
+std::unique_ptr<Graphics::VertexArray> ProjectileManager::s_beamSideVerts;
+std::unique_ptr<Graphics::VertexArray> ProjectileManager::s_beamGlowVerts;
+std::unique_ptr<Graphics::Material> ProjectileManager::s_boltSideMat;
+std::unique_ptr<Graphics::Material> ProjectileManager::s_beamSideMat;
+std::unique_ptr<Graphics::Material> ProjectileManager::s_glowMat;
+Graphics::RenderState *ProjectileManager::s_renderState = nullptr;
+
+void ProjectileManager::BuildModel()
 {
 	//set up materials
 	Graphics::MaterialDescriptor desc;
 	desc.textures = 1;
-	s_sideMat.reset(Pi::renderer->CreateMaterial(desc));
+	desc.vertexColors = true;
+	s_boltSideMat.reset(Pi::renderer->CreateMaterial(desc));
+	s_beamSideMat.reset(Pi::renderer->CreateMaterial(desc));
 	s_glowMat.reset(Pi::renderer->CreateMaterial(desc));
-	s_sideMat->texture0 = Graphics::TextureBuilder::Billboard("textures/projectile_l.dds").GetOrCreateTexture(Pi::renderer, "billboard");
+	s_boltSideMat->texture0 = Graphics::TextureBuilder::Billboard("textures/projectile_l.dds").GetOrCreateTexture(Pi::renderer, "billboard");
+	s_beamSideMat->texture0 = Graphics::TextureBuilder::Billboard("textures/beam_l.dds").GetOrCreateTexture(Pi::renderer, "billboard");
 	s_glowMat->texture0 = Graphics::TextureBuilder::Billboard("textures/projectile_w.dds").GetOrCreateTexture(Pi::renderer, "billboard");
 
 	//zero at projectile position
@@ -59,42 +87,66 @@ void Projectile::BuildModel()
 	const vector2f botLeft(0.f, 0.f);
 	const vector2f botRight(1.f, 0.f);
 
-	s_sideVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_UV0));
-	s_glowVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_UV0));
+	s_boltSideVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_UV0, 24));
+	s_boltGlowVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_UV0, 24));
+	s_beamGlowVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_UV0, 240));
 
 	//add four intersecting planes to create a volumetric effect
 	for (int i = 0; i < 4; i++) {
-		s_sideVerts->Add(one, topLeft);
-		s_sideVerts->Add(two, topRight);
-		s_sideVerts->Add(three, botRight);
+		s_boltSideVerts->Add(one, topLeft);
+		s_boltSideVerts->Add(two, topRight);
+		s_boltSideVerts->Add(three, botRight);
 
-		s_sideVerts->Add(three, botRight);
-		s_sideVerts->Add(four, botLeft);
-		s_sideVerts->Add(one, topLeft);
+		s_boltSideVerts->Add(three, botRight);
+		s_boltSideVerts->Add(four, botLeft);
+		s_boltSideVerts->Add(one, topLeft);
 
 		one.ArbRotate(vector3f(0.f, 0.f, 1.f), DEG2RAD(45.f));
 		two.ArbRotate(vector3f(0.f, 0.f, 1.f), DEG2RAD(45.f));
 		three.ArbRotate(vector3f(0.f, 0.f, 1.f), DEG2RAD(45.f));
 		four.ArbRotate(vector3f(0.f, 0.f, 1.f), DEG2RAD(45.f));
 	}
+	// beams have the same sides, only textured differently
+	s_beamSideVerts.reset(new Graphics::VertexArray(*s_boltSideVerts));
 
 	//create quads for viewing on end
 	float gw = 0.5f;
 	float gz = -0.1f;
 
 	for (int i = 0; i < 4; i++) {
-		s_glowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
-		s_glowVerts->Add(vector3f(-gw, gw, gz), topRight);
-		s_glowVerts->Add(vector3f(gw, gw, gz), botRight);
+		s_boltGlowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
+		s_boltGlowVerts->Add(vector3f(-gw, gw, gz), topRight);
+		s_boltGlowVerts->Add(vector3f(gw, gw, gz), botRight);
 
-		s_glowVerts->Add(vector3f(gw, gw, gz), botRight);
-		s_glowVerts->Add(vector3f(gw, -gw, gz), botLeft);
-		s_glowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
+		s_boltGlowVerts->Add(vector3f(gw, gw, gz), botRight);
+		s_boltGlowVerts->Add(vector3f(gw, -gw, gz), botLeft);
+		s_boltGlowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
 
 		gw -= 0.1f; // they get smaller
 		gz -= 0.2f; // as they move back
 	}
 
+	// beams glow all along their length
+	gw = 0.5f;
+	gz = -0.1f;
+
+	for (int i = 0; i < 40; i++) {
+		s_beamGlowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
+		s_beamGlowVerts->Add(vector3f(-gw, gw, gz), topRight);
+		s_beamGlowVerts->Add(vector3f(gw, gw, gz), botRight);
+
+		s_beamGlowVerts->Add(vector3f(gw, gw, gz), botRight);
+		s_beamGlowVerts->Add(vector3f(gw, -gw, gz), botLeft);
+		s_beamGlowVerts->Add(vector3f(-gw, -gw, gz), topLeft);
+
+		gz -= 0.02f; // as they move back
+	}
+
+	const Graphics::AttributeSet batchAttribs = Graphics::ATTRIB_POSITION | Graphics::ATTRIB_DIFFUSE | Graphics::ATTRIB_UV0;
+	s_boltSideBatch.reset(new Graphics::VertexArray(batchAttribs));
+	s_beamSideBatch.reset(new Graphics::VertexArray(batchAttribs));
+	s_glowBatch.reset(new Graphics::VertexArray(batchAttribs));
+
 	Graphics::RenderStateDesc rsd;
 	rsd.blendMode = Graphics::BLEND_ALPHA_ONE;
 	rsd.depthWrite = false;
@@ -102,125 +154,98 @@ void Projectile::BuildModel()
 	s_renderState = Pi::renderer->CreateRenderState(rsd);
 }
 
-void Projectile::FreeModel()
+void ProjectileManager::FreeModel()
 {
-	s_sideMat.reset();
+	s_boltSideMat.reset();
+	s_beamSideMat.reset();
 	s_glowMat.reset();
-	s_sideVerts.reset();
-	s_glowVerts.reset();
-}
-
-Projectile::Projectile(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel) :
-	Body()
-{
-	if (!s_sideMat) BuildModel();
-	m_flags |= FLAG_DRAW_LAST;
-
-	m_parent = parent;
-	m_lifespan = prData.lifespan;
-	m_baseDam = prData.damage;
-	m_length = prData.length;
-	m_width = prData.width;
-	m_mining = prData.mining;
-	m_color = prData.color;
-	m_age = 0;
-
-	SetFrame(parent->GetFrame());
-
-	SetOrient(parent->GetOrient());
-	SetPosition(pos);
-	m_baseVel = baseVel;
-	m_dirVel = dirVel;
-	SetClipRadius(GetRadius());
-	SetPhysRadius(GetRadius());
-}
-
-Projectile::Projectile(const Json &jsonObj, Space *space) :
-	Body(jsonObj, space)
-{
-	if (!s_sideMat) BuildModel();
-
-	try {
-		Json projectileObj = jsonObj["projectile"];
-
-		m_baseVel = projectileObj["base_vel"];
-		m_dirVel = projectileObj["dir_vel"];
-		m_age = projectileObj["age"];
-		m_lifespan = projectileObj["life_span"];
-		m_baseDam = projectileObj["base_dam"];
-		m_length = projectileObj["length"];
-		m_width = projectileObj["width"];
-		m_mining = projectileObj["mining"];
-		m_color = projectileObj["color"];
-		m_parentIndex = projectileObj["index_for_body"];
-	} catch (Json::type_error &) {
-		throw SavedGameCorruptException();
-	}
+	s_boltSideVerts.reset();
+	s_boltGlowVerts.reset();
+	s_beamSideVerts.reset();
+	s_beamGlowVerts.reset();
+	s_boltSideBatch.reset();
+	s_beamSideBatch.reset();
+	s_glowBatch.reset();
 }
 
-Projectile::~Projectile()
+void ProjectileManager::AddBolt(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel)
 {
+	Pi::game->GetSpace()->GetProjectiles()->Add(parent, prData, pos, baseVel, dirVel, prData.mining ? FLAG_MINING : 0);
 }
 
-void Projectile::SaveToJson(Json &jsonObj, Space *space)
+void ProjectileManager::AddBeam(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dir)
 {
-	Body::SaveToJson(jsonObj, space);
-
-	Json projectileObj({}); // Create JSON object to contain projectile data.
-
-	projectileObj["base_vel"] = m_baseVel;
-	projectileObj["dir_vel"] = m_dirVel;
-	projectileObj["age"] = m_age;
-	projectileObj["life_span"] = m_lifespan;
-	projectileObj["base_dam"] = m_baseDam;
-	projectileObj["length"] = m_length;
-	projectileObj["width"] = m_width;
-	projectileObj["mining"] = m_mining;
-	projectileObj["color"] = m_color;
-	projectileObj["index_for_body"] = space->GetIndexForBody(m_parent);
-
-	jsonObj["projectile"] = projectileObj; // Add projectile object to supplied object.
+	ProjectileData beamData = prData;
+	beamData.lifespan = BEAM_LIFETIME;
+	beamData.width = 1.0f;
+	Pi::game->GetSpace()->GetProjectiles()->Add(parent, beamData, pos, baseVel, dir, FLAG_BEAM | (prData.mining ? FLAG_MINING : 0));
 }
 
-void Projectile::PostLoadFixup(Space *space)
+void ProjectileManager::Add(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel, Uint8 flags)
 {
-	Body::PostLoadFixup(space);
-	m_parent = space->GetBodyByIndex(m_parentIndex);
+	if (!s_boltSideMat) BuildModel();
+
+	m_frame.push_back(parent->GetFrame());
+	m_pos.push_back(pos);
+	m_baseVel.push_back(baseVel);
+	m_dirVel.push_back(dirVel);
+	m_age.push_back(0.0f);
+	m_lifespan.push_back(prData.lifespan);
+	m_damage.push_back(prData.damage);
+	m_length.push_back(prData.length);
+	m_width.push_back(prData.width);
+	m_color.push_back(prData.color);
+	m_flags.push_back(flags);
+	m_parent.push_back(parent);
 }
 
-void Projectile::UpdateInterpTransform(double alpha)
+void ProjectileManager::MoveEntry(size_t from, size_t to)
 {
-	m_interpOrient = GetOrient();
-	const vector3d oldPos = GetPosition() - (m_baseVel + m_dirVel) * Pi::game->GetTimeStep();
-	m_interpPos = alpha * GetPosition() + (1.0 - alpha) * oldPos;
+	m_frame[to] = m_frame[from];
+	m_pos[to] = m_pos[from];
+	m_baseVel[to] = m_baseVel[from];
+	m_dirVel[to] = m_dirVel[from];
+	m_age[to] = m_age[from];
+	m_lifespan[to] = m_lifespan[from];
+	m_damage[to] = m_damage[from];
+	m_length[to] = m_length[from];
+	m_width[to] = m_width[from];
+	m_color[to] = m_color[from];
+	m_flags[to] = m_flags[from];
+	m_parent[to] = m_parent[from];
 }
 
-void Projectile::NotifyRemoved(const Body *const removedBody)
+void ProjectileManager::PopEntry()
 {
-	if (m_parent == removedBody) m_parent = 0;
+	m_frame.pop_back();
+	m_pos.pop_back();
+	m_baseVel.pop_back();
+	m_dirVel.pop_back();
+	m_age.pop_back();
+	m_lifespan.pop_back();
+	m_damage.pop_back();
+	m_length.pop_back();
+	m_width.pop_back();
+	m_color.pop_back();
+	m_flags.pop_back();
+	m_parent.pop_back();
 }
 
-void Projectile::TimeStepUpdate(const float timeStep)
+void ProjectileManager::NotifyRemoved(const Body *const removedBody)
 {
-	m_age += timeStep;
-	SetPosition(GetPosition() + (m_baseVel + m_dirVel) * double(timeStep));
-	if (m_age > m_lifespan) Pi::game->GetSpace()->KillBody(this);
+	for (Body *&parent : m_parent)
+		if (parent == removedBody) parent = nullptr;
 }
 
 /* In hull kg */
-float Projectile::GetDamage() const
-{
-	return m_baseDam * sqrt((m_lifespan - m_age) / m_lifespan);
-	// TEST
-	//	return 0.01f;
-}
-
-double Projectile::GetRadius() const
+float ProjectileManager::GetDamage(size_t i) const
 {
-	return sqrt(m_length * m_length + m_width * m_width);
+	if (m_flags[i] & FLAG_BEAM)
+		return m_damage[i];
+	return m_damage[i] * sqrt((m_lifespan[i] - m_age[i]) / m_lifespan[i]);
 }
 
-void MiningLaserSpawnTastyStuff(FrameId fId, const SystemBody *asteroid, const vector3d &pos)
+static void MiningLaserSpawnTastyStuff(FrameId fId, const SystemBody *asteroid, const vector3d &pos)
 {
 	lua_State *l = Lua::manager->GetLuaState();
 
@@ -253,128 +278,258 @@ void MiningLaserSpawnTastyStuff(FrameId fId, const SystemBody *asteroid, const v
 	Pi::game->GetSpace()->AddBody(cargo);
 }
 
-void Projectile::StaticUpdate(const float timeStep)
+void ProjectileManager::StaticUpdate(const float timeStep)
 {
 	PROFILE_SCOPED()
-	CollisionContact c;
-	// Collision spaces don't store velocity, so dirvel-only is still wrong but less awful than dirvel+basevel
-	vector3d vel = m_dirVel * timeStep;
-	Frame *frame = Frame::GetFrame(GetFrame());
-	frame->GetCollisionSpace()->TraceRay(GetPosition(), vel.Normalized(), vel.Length(), &c);
-
-	if (c.userData1) {
-		Object *o = static_cast<Object *>(c.userData1);
-
-		if (o->IsType(Object::CITYONPLANET)) {
-			Pi::game->GetSpace()->KillBody(this);
-		} else if (o->IsType(Object::BODY)) {
-			Body *hit = static_cast<Body *>(o);
-			if (hit != m_parent) {
-				hit->OnDamage(m_parent, GetDamage(), c);
-				Pi::game->GetSpace()->KillBody(this);
-				if (hit->IsType(Object::SHIP))
-					LuaEvent::Queue("onShipHit", dynamic_cast<Ship *>(hit), dynamic_cast<Body *>(m_parent));
+	const size_t count = m_frame.size();
+	if (!count)
+		return;
+
+	// group by frame, to look up each collision space and planet only once
+	m_byFrame.resize(count);
+	for (Uint32 i = 0; i < count; i++)
+		m_byFrame[i] = i;
+	std::sort(m_byFrame.begin(), m_byFrame.end(), [this](Uint32 a, Uint32 b) {
+		return m_frame[a].id() < m_frame[b].id();
+	});
+
+	for (size_t begin = 0, end; begin < count; begin = end) {
+		const FrameId frameId = m_frame[m_byFrame[begin]];
+		for (end = begin + 1; end < count && m_frame[m_byFrame[end]] == frameId;)
+			end++;
+
+		Frame *frame = Frame::GetFrame(frameId);
+		CollisionSpace *collisionSpace = frame->GetCollisionSpace();
+		Planet *planet = nullptr;
+		if (frame->GetBody() && frame->GetBody()->IsType(Object::PLANET))
+			planet = static_cast<Planet *>(frame->GetBody());
+
+		for (size_t j = begin; j < end; j++) {
+			const Uint32 i = m_byFrame[j];
+			// spent beams are dead in effect but still rendered
+			if (m_flags[i] & (FLAG_SPENT | FLAG_DEAD))
+				continue;
+
+			const bool beam = m_flags[i] & FLAG_BEAM;
+			const Uint8 hitFlag = beam ? FLAG_SPENT : FLAG_DEAD;
+			Body *parent = m_parent[i];
+
+			CollisionContact c;
+			if (beam) {
+				const Geom *ignore = parent && parent->IsType(Object::MODELBODY) ? static_cast<ModelBody *>(parent)->GetGeom() : nullptr;
+				collisionSpace->TraceRay(m_pos[i], m_dirVel[i].Normalized(), m_length[i], &c, ignore);
+			} else {
+				// Collision spaces don't store velocity, so dirvel-only is still wrong but less awful than dirvel+basevel
+				const vector3d vel = m_dirVel[i] * timeStep;
+				collisionSpace->TraceRay(m_pos[i], vel.Normalized(), vel.Length(), &c);
 			}
-		}
-	}
-	if (m_mining) // mining lasers can break off chunks of terrain
-	{
-		// need to test for terrain hit
-		Planet *const planet = static_cast<Planet *>(frame->GetBody()); // cache the value even for the if statement
-		if (planet && planet->IsType(Object::PLANET)) {
-			vector3d pos = GetPosition();
-			double terrainHeight = planet->GetTerrainHeight(pos.Normalized());
-			if (terrainHeight > pos.Length()) {
-				const SystemBody *b = planet->GetSystemBody();
-				// hit the fucker
-				if (b->GetType() == SystemBody::TYPE_PLANET_ASTEROID) {
-					vector3d n = GetPosition().Normalized();
-					MiningLaserSpawnTastyStuff(planet->GetFrame(), b, n * terrainHeight + 5.0 * n);
-					SfxManager::Add(this, TYPE_EXPLOSION);
+
+			if (c.userData1) {
+				Object *o = static_cast<Object *>(c.userData1);
+
+				if (o->IsType(Object::CITYONPLANET)) {
+					m_flags[i] |= FLAG_DEAD;
+				} else if (o->IsType(Object::BODY)) {
+					Body *hit = static_cast<Body *>(o);
+					if (hit != parent) {
+						hit->OnDamage(parent, GetDamage(i), c);
+						m_flags[i] |= hitFlag;
+						if (hit->IsType(Object::SHIP))
+							LuaEvent::Queue("onShipHit", dynamic_cast<Ship *>(hit), parent);
+					}
+				}
+			}
+
+			// mining lasers can break off chunks of terrain
+			if ((m_flags[i] & FLAG_MINING) && !(m_flags[i] & (FLAG_SPENT | FLAG_DEAD)) && planet) {
+				// need to test for terrain hit
+				const vector3d pos = m_pos[i];
+				const double terrainHeight = planet->GetTerrainHeight(pos.Normalized());
+				if (terrainHeight > pos.Length()) {
+					const SystemBody *b = planet->GetSystemBody();
+					// hit the fucker
+					if (b->GetType() == SystemBody::TYPE_PLANET_ASTEROID) {
+						const vector3d n = pos.Normalized();
+						MiningLaserSpawnTastyStuff(planet->GetFrame(), b, n * terrainHeight + 5.0 * n);
+						SfxManager::Add(frameId, pos, vector3d(0.0), TYPE_EXPLOSION);
+					}
+					m_flags[i] |= hitFlag;
 				}
-				Pi::game->GetSpace()->KillBody(this);
 			}
 		}
 	}
 }
 
-void Projectile::Render(Graphics::Renderer *renderer, const Camera *camera, const vector3d &viewCoords, const matrix4x4d &viewTransform)
+void ProjectileManager::TimeStepUpdate(const float timeStep)
 {
 	PROFILE_SCOPED()
-	vector3d _from = viewTransform * GetInterpPosition();
-	vector3d _to = viewTransform * (GetInterpPosition() + m_dirVel);
-	vector3d _dir = _to - _from;
-	vector3f from(&_from.x);
-	vector3f dir = vector3f(_dir).Normalized();
-
-	vector3f v1, v2;
-	matrix4x4f m = matrix4x4f::Identity();
-	v1.x = dir.y;
-	v1.y = dir.z;
-	v1.z = dir.x;
-	v2 = v1.Cross(dir).Normalized();
-	v1 = v2.Cross(dir);
-	m[0] = v1.x;
-	m[4] = v2.x;
-	m[8] = dir.x;
-	m[1] = v1.y;
-	m[5] = v2.y;
-	m[9] = dir.y;
-	m[2] = v1.z;
-	m[6] = v2.z;
-	m[10] = dir.z;
-
-	m[12] = from.x;
-	m[13] = from.y;
-	m[14] = from.z;
-
-	// increase visible size based on distance from camera, z is always negative
-	// allows them to be smaller while maintaining visibility for game play
-	const float dist_scale = float(viewCoords.z / -500);
-	const float length = m_length + dist_scale;
-	const float width = m_width + dist_scale;
-
-	renderer->SetTransform(m * matrix4x4f::ScaleMatrix(width, width, length));
-
-	Color color = m_color;
-	// fade them out as they age so they don't suddenly disappear
-	// this matches the damage fall-off calculation
-	const float base_alpha = sqrt(1.0f - m_age / m_lifespan);
-	// fade out side quads when viewing nearly edge on
-	vector3f view_dir = vector3f(viewCoords).Normalized();
-	color.a = (base_alpha * (1.f - powf(fabs(dir.Dot(view_dir)), length))) * 255;
-
-	if (color.a > 3) {
-		s_sideMat->diffuse = color;
-		renderer->DrawTriangles(s_sideVerts.get(), s_renderState, s_sideMat.get());
+	for (size_t i = 0; i < m_frame.size(); i++) {
+		const vector3d vel = (m_flags[i] & FLAG_BEAM) ? m_baseVel[i] : m_baseVel[i] + m_dirVel[i];
+		m_pos[i] += vel * double(timeStep);
+		m_age[i] += timeStep;
+		if (m_age[i] > m_lifespan[i])
+			m_flags[i] |= FLAG_DEAD;
+	}
+
+	// the order doesn't matter, so fill the holes from the back
+	for (size_t i = m_frame.size(); i-- > 0;) {
+		if (!(m_flags[i] & FLAG_DEAD))
+			continue;
+		if (i != m_frame.size() - 1)
+			MoveEntry(m_frame.size() - 1, i);
+		PopEntry();
 	}
+}
+
+void ProjectileManager::Render(Graphics::Renderer *renderer, const Camera *camera, FrameId camFrame)
+{
+	PROFILE_SCOPED()
+	if (m_frame.empty())
+		return;
+
+	s_boltSideBatch->Clear();
+	s_beamSideBatch->Clear();
+	s_glowBatch->Clear();
+
+	const Graphics::Frustum &frustum = camera->GetContext()->GetFrustum();
+	// how far back from the current positions to draw, like Body::UpdateInterpTransform
+	const double interpTime = (double(Pi::GetGameTickAlpha()) - 1.0) * Pi::game->GetTimeStep();
+	// for the pixel size cull Camera applies to bodies
+	const double pixelScale = Graphics::GetScreenHeight() * 2.0 / Graphics::GetFovFactor();
+
+	FrameId viewFrame;
+	matrix4x4d viewTransform;
+	for (size_t i = 0; i < m_frame.size(); i++) {
+		// bolts are fired in bursts, mostly from the same frame
+		if (m_frame[i] != viewFrame) {
+			viewFrame = m_frame[i];
+			Frame *f = Frame::GetFrame(viewFrame);
+			viewTransform = f->GetInterpOrientRelTo(camFrame);
+			viewTransform.SetTranslate(f->GetInterpPositionRelTo(camFrame));
+		}
+
+		const bool beam = m_flags[i] & FLAG_BEAM;
+		const vector3d vel = beam ? m_baseVel[i] : m_baseVel[i] + m_dirVel[i];
+		const vector3d interpPos = m_pos[i] + vel * interpTime;
+
+		const vector3d _from = viewTransform * interpPos;
+		const double clipRadius = sqrt(m_length[i] * m_length[i] + m_width[i] * m_width[i]);
+		if (!frustum.TestPointInfinite(_from, clipRadius))
+			continue;
+		if (pixelScale * clipRadius < Camera::OBJECT_HIDDEN_PIXEL_THRESHOLD * _from.Length())
+			continue;
+
+		const vector3d _to = viewTransform * (interpPos + (beam ? -m_dirVel[i] : m_dirVel[i]));
+		const vector3f from(_from);
+		const vector3f dir = vector3f(_to - _from).Normalized();
+
+		vector3f v1, v2;
+		v1.x = dir.y;
+		v1.y = dir.z;
+		v1.z = dir.x;
+		v2 = v1.Cross(dir).Normalized();
+		v1 = v2.Cross(dir);
+
+		// increase visible size based on distance from camera, z is always negative
+		// allows them to be smaller while maintaining visibility for game play
+		const float dist_scale = float(_from.z / -500);
+		const float length = m_length[i] + dist_scale;
+		const float width = m_width[i] + dist_scale;
+
+		Color color = m_color[i];
+		// fade bolts out as they age so they don't suddenly disappear
+		// this matches the damage fall-off calculation
+		const float base_alpha = beam ? 1.0f : sqrt(1.0f - m_age[i] / m_lifespan[i]);
+		// fade out side quads when viewing nearly edge on
+		const vector3f view_dir = from.Normalized();
+		const float facing = fabs(dir.Dot(view_dir));
+		color.a = (base_alpha * (1.f - powf(facing, length))) * 255;
+
+		if (color.a > 3) {
+			if (beam)
+				AddTransformed(*s_beamSideBatch, *s_beamSideVerts, from, v1 * width, v2 * width, dir * length, color);
+			else
+				AddTransformed(*s_boltSideBatch, *s_boltSideVerts, from, v1 * width, v2 * width, dir * length, color);
+		}
 
-	// fade out glow quads when viewing nearly edge on
-	// these and the side quads fade at different rates
-	// so that they aren't both at the same alpha as that looks strange
-	color.a = (base_alpha * powf(fabs(dir.Dot(view_dir)), width)) * 255;
+		// fade out glow quads when viewing nearly edge on
+		// these and the side quads fade at different rates
+		// so that they aren't both at the same alpha as that looks strange
+		color.a = (base_alpha * powf(facing, width)) * 255;
 
-	if (color.a > 3) {
-		s_glowMat->diffuse = color;
-		renderer->DrawTriangles(s_glowVerts.get(), s_renderState, s_glowMat.get());
+		if (color.a > 3)
+			AddTransformed(*s_glowBatch, beam ? *s_beamGlowVerts : *s_boltGlowVerts, from, v1 * width, v2 * width, dir * length, color);
 	}
+
+	// everything is already in camera space
+	Graphics::Renderer::MatrixTicket mt(renderer, matrix4x4f::Identity());
+	if (!s_boltSideBatch->IsEmpty())
+		renderer->DrawTriangles(s_boltSideBatch.get(), s_renderState, s_boltSideMat.get());
+	if (!s_beamSideBatch->IsEmpty())
+		renderer->DrawTriangles(s_beamSideBatch.get(), s_renderState, s_beamSideMat.get());
+	if (!s_glowBatch->IsEmpty())
+		renderer->DrawTriangles(s_glowBatch.get(), s_renderState, s_glowMat.get());
 }
 
-void Projectile::Add(Body *parent, float lifespan, float dam, float length, float width, bool mining, const Color &color, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel)
+void ProjectileManager::ToJson(Json &jsonObj, Space *space) const
 {
-	ProjectileData prData;
-	prData.lifespan = lifespan;
-	prData.damage = dam;
-	prData.length = length;
-	prData.width = width;
-	prData.mining = mining;
-	prData.color = color;
-	Projectile *p = new Projectile(parent, prData, pos, baseVel, dirVel);
-	Pi::game->GetSpace()->AddBody(p);
+	Json projectileArray = Json::array(); // Create JSON array to contain projectile data.
+	for (size_t i = 0; i < m_frame.size(); i++) {
+		Json projectileObj({}); // Create JSON object to contain projectile.
+
+		projectileObj["index_for_frame"] = m_frame[i];
+		projectileObj["pos"] = m_pos[i];
+		projectileObj["base_vel"] = m_baseVel[i];
+		projectileObj["dir_vel"] = m_dirVel[i];
+		projectileObj["age"] = m_age[i];
+		projectileObj["life_span"] = m_lifespan[i];
+		projectileObj["base_dam"] = m_damage[i];
+		projectileObj["length"] = m_length[i];
+		projectileObj["width"] = m_width[i];
+		projectileObj["color"] = m_color[i];
+		projectileObj["beam"] = bool(m_flags[i] & FLAG_BEAM);
+		projectileObj["mining"] = bool(m_flags[i] & FLAG_MINING);
+		projectileObj["spent"] = bool(m_flags[i] & FLAG_SPENT);
+		projectileObj["index_for_body"] = space->GetIndexForBody(m_parent[i]);
+
+		projectileArray.push_back(projectileObj); // Append projectile object to array.
+	}
+	jsonObj["projectiles"] = projectileArray; // Add projectile array to supplied object.
 }
 
-void Projectile::Add(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel)
+void ProjectileManager::FromJson(const Json &jsonObj, Space *space)
 {
-	Projectile *p = new Projectile(parent, prData, pos, baseVel, dirVel);
-	Pi::game->GetSpace()->AddBody(p);
+	try {
+		Json projectileArray = jsonObj["projectiles"].get<Json::array_t>();
+		for (const Json &projectileObj : projectileArray) {
+			ProjectileData prData;
+			prData.lifespan = projectileObj["life_span"];
+			prData.damage = projectileObj["base_dam"];
+			prData.length = projectileObj["length"];
+			prData.width = projectileObj["width"];
+			prData.color = projectileObj["color"];
+
+			Uint8 flags = 0;
+			if (projectileObj["beam"].get<bool>()) flags |= FLAG_BEAM;
+			if (projectileObj["mining"].get<bool>()) flags |= FLAG_MINING;
+			if (projectileObj["spent"].get<bool>()) flags |= FLAG_SPENT;
+
+			m_frame.push_back(projectileObj["index_for_frame"].get<FrameId>());
+			m_pos.push_back(projectileObj["pos"].get<vector3d>());
+			m_baseVel.push_back(projectileObj["base_vel"].get<vector3d>());
+			m_dirVel.push_back(projectileObj["dir_vel"].get<vector3d>());
+			m_age.push_back(projectileObj["age"].get<float>());
+			m_lifespan.push_back(prData.lifespan);
+			m_damage.push_back(prData.damage);
+			m_length.push_back(prData.length);
+			m_width.push_back(prData.width);
+			m_color.push_back(prData.color);
+			m_flags.push_back(flags);
+			m_parent.push_back(space->GetBodyByIndex(projectileObj["index_for_body"].get<Uint32>()));
+		}
+	} catch (Json::type_error &) {
+		throw SavedGameCorruptException();
+	}
+
+	if (!m_frame.empty() && !s_boltSideMat) BuildModel();
 }
@@ -4,7 +4,13 @@
 #ifndef _PROJECTILE_H
 #define _PROJECTILE_H
 
-#include "Body.h"
+#include "Color.h"
+#include "FrameId.h"
+#include "JsonFwd.h"
+#include "vector3.h"
+
+#include <memory>
+#include <vector>
 
 struct ProjectileData {
 	ProjectileData() :
@@ -26,7 +32,9 @@ struct ProjectileData {
 	bool beam;
 };
 
-class Frame;
+class Body;
+class Camera;
+class Space;
 
 namespace Graphics {
 	class Material;
@@ -35,50 +43,75 @@ namespace Graphics {
 	class VertexArray;
 } // namespace Graphics
 
-class Projectile : public Body {
+/*
+ * Laser bolts and beams. There are far too many of them, living for far too
+ * short a time, to make each one a Body: every Space keeps all of its
+ * projectiles in one pool instead, stored as parallel arrays. They never
+ * change frame, so they are moved in one pass, ray cast grouped by the
+ * collision space of their frame and rendered as one batch per material.
+ */
+class ProjectileManager {
 public:
-	OBJDEF(Projectile, Body, PROJECTILE);
-
-	static void Add(Body *parent, float lifespan, float dam, float length, float width, bool mining, const Color &color, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel);
-	static void Add(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel);
-
-	Projectile() = delete;
-	Projectile(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel);
-	Projectile(const Json &jsonObj, Space *space);
-	virtual ~Projectile();
-	virtual void Render(Graphics::Renderer *r, const Camera *camera, const vector3d &viewCoords, const matrix4x4d &viewTransform) override final;
-	void TimeStepUpdate(const float timeStep) override final;
-	void StaticUpdate(const float timeStep) override final;
-	virtual void NotifyRemoved(const Body *const removedBody) override final;
-	virtual void UpdateInterpTransform(double alpha) override final;
-	virtual void PostLoadFixup(Space *space) override final;
+	// fire from parent, into its frame. dirVel is the velocity of the bolt
+	// relative to the parent, dir the direction of the beam
+	static void AddBolt(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel);
+	static void AddBeam(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dir);
 
 	static void FreeModel();
 
-protected:
-	virtual void SaveToJson(Json &jsonObj, Space *space) override final;
+	// hit tests against the current positions, then moves and ages everything
+	void StaticUpdate(const float timeStep);
+	void TimeStepUpdate(const float timeStep);
+
+	void Render(Graphics::Renderer *renderer, const Camera *camera, FrameId camFrame);
+
+	void NotifyRemoved(const Body *const removedBody);
+
+	// body indices must be valid on the space
+	void ToJson(Json &jsonObj, Space *space) const;
+	void FromJson(const Json &jsonObj, Space *space);
+
+	size_t GetNumProjectiles() const { return m_frame.size(); }
 
 private:
-	float GetDamage() const;
-	double GetRadius() const;
-	Body *m_parent;
-	vector3d m_baseVel;
-	vector3d m_dirVel;
-	float m_age;
-	float m_lifespan;
-	float m_baseDam;
-	float m_length;
-	float m_width;
-	bool m_mining;
-	Color m_color;
-
-	int m_parentIndex; // deserialisation
+	enum Flags {
+		FLAG_BEAM = 1 << 0,
+		FLAG_MINING = 1 << 1,
+		FLAG_SPENT = 1 << 2, // beams that hit something are still drawn for the rest of their life
+		FLAG_DEAD = 1 << 3	 // removed at the end of the timestep
+	};
+
+	void Add(Body *parent, const ProjectileData &prData, const vector3d &pos, const vector3d &baseVel, const vector3d &dirVel, Uint8 flags);
+	void MoveEntry(size_t from, size_t to);
+	void PopEntry();
+
+	float GetDamage(size_t i) const;
 
 	static void BuildModel();
 
-	static std::unique_ptr<Graphics::VertexArray> s_sideVerts;
-	static std::unique_ptr<Graphics::VertexArray> s_glowVerts;
-	static std::unique_ptr<Graphics::Material> s_sideMat;
+	// one entry per projectile in each array
+	std::vector<FrameId> m_frame;
+	std::vector<vector3d> m_pos;
+	std::vector<vector3d> m_baseVel;
+	std::vector<vector3d> m_dirVel; // bolts: velocity relative to the parent; beams: direction
+	std::vector<float> m_age;
+	std::vector<float> m_lifespan;
+	std::vector<float> m_damage;
+	std::vector<float> m_length;
+	std::vector<float> m_width;
+	std::vector<Color> m_color;
+	std::vector<Uint8> m_flags;
+	std::vector<Body *> m_parent;
+
+	// projectile indices ordered by frame, rebuilt every timestep
+	std::vector<Uint32> m_byFrame;
+
+	static std::unique_ptr<Graphics::VertexArray> s_boltSideVerts;
+	static std::unique_ptr<Graphics::VertexArray> s_boltGlowVerts;
+	static std::unique_ptr<Graphics::VertexArray> s_beamSideVerts;
+	static std::unique_ptr<Graphics::VertexArray> s_beamGlowVerts;
+	static std::unique_ptr<Graphics::Material> s_boltSideMat;
+	static std::unique_ptr<Graphics::Material> s_beamSideMat;
 	static std::unique_ptr<Graphics::Material> s_glowMat;
 	static Graphics::RenderState *s_renderState;
 };
@@ -15,6 +15,7 @@
 #include "StringF.h"
 #include "galaxy/Galaxy.h"
 #include "galaxy/GalaxyCache.h"
+#include "galaxy/GalaxyGenerator.h"
 #include "galaxy/Sector.h"
 #include "galaxy/StarSystem.h"
 #include "graphics/Graphics.h"
@@ -122,6 +123,8 @@ void SectorView::InitDefaults()
 	const float farPos = static_cast<float>(INT_MAX);
 	m_secPosFar = vector3f(farPos, farPos, farPos);
 	m_radiusFar = 0;
+	m_farSectorsPending = false;
+	m_farSectorsArrived = false;
 	m_cacheXMin = 0;
 	m_cacheXMax = 0;
 	m_cacheYMin = 0;
@@ -982,21 +985,48 @@ void SectorView::DrawFarSectors(const matrix4x4f &modelview)
 	const vector3f secOrigin = vector3f(int(floorf(m_pos.x)), int(floorf(m_pos.y)), int(floorf(m_pos.z)));
 
 	// build vertex and colour arrays for all the stars we want to see, if we don't already have them
-	if (m_toggledFaction || buildRadius != m_radiusFar || !secOrigin.ExactlyEqual(m_secPosFar)) {
+	if (m_toggledFaction || m_farSectorsArrived || buildRadius != m_radiusFar || !secOrigin.ExactlyEqual(m_secPosFar)) {
 		m_farstars.clear();
 		m_farstarsColor.clear();
 		m_visibleFactions.clear();
+		m_farSectorsArrived = false;
 
+		// sectors that aren't cached yet are generated in the background,
+		// and everything is rebuilt once they're in. sectors the galaxy
+		// generator knows to be empty aren't generated at all
+		RefCountedPtr<GalaxyGenerator> generator = m_galaxy->GetGenerator();
+		std::vector<SystemPath> missing;
 		for (int sx = secOrigin.x - buildRadius; sx <= secOrigin.x + buildRadius; sx++) {
 			for (int sy = secOrigin.y - buildRadius; sy <= secOrigin.y + buildRadius; sy++) {
 				for (int sz = secOrigin.z - buildRadius; sz <= secOrigin.z + buildRadius; sz++) {
-					if ((vector3f(sx, sy, sz) - secOrigin).Length() <= buildRadius) {
-						BuildFarSector(GetCached(SystemPath(sx, sy, sz)), Sector::SIZE * secOrigin, m_farstars, m_farstarsColor);
-					}
+					if ((vector3f(sx, sy, sz) - secOrigin).Length() > buildRadius)
+						continue;
+					if (!generator->SectorMayHaveSystems(m_galaxy, sx, sy, sz))
+						continue;
+
+					const SystemPath path(sx, sy, sz);
+					RefCountedPtr<Sector> sec = m_sectorCache->GetIfCached(path);
+					if (sec)
+						BuildFarSector(sec, Sector::SIZE * secOrigin, m_farstars, m_farstarsColor);
+					else
+						missing.push_back(path);
 				}
 			}
 		}
 
+		if (!missing.empty() && !m_farSectorsPending) {
+			// nearest first
+			std::sort(missing.begin(), missing.end(), [&secOrigin](const SystemPath &a, const SystemPath &b) {
+				return (vector3f(a.sectorX, a.sectorY, a.sectorZ) - secOrigin).LengthSqr() <
+					(vector3f(b.sectorX, b.sectorY, b.sectorZ) - secOrigin).LengthSqr();
+			});
+			m_farSectorsPending = true;
+			m_sectorCache->FillCache(missing, [this]() {
+				m_farSectorsPending = false;
+				m_farSectorsArrived = true;
+			});
+		}
+
 		m_secPosFar = secOrigin;
 		m_radiusFar = buildRadius;
 		m_toggledFaction = false;
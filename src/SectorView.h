@@ -209,6 +209,9 @@ private:
 	vector3f m_secPosFar;
 	int m_radiusFar;
 	bool m_toggledFaction;
+	// far sectors are generated in the background, one batch at a time
+	bool m_farSectorsPending;
+	bool m_farSectorsArrived;
 
 	int m_cacheXMin;
 	int m_cacheXMax;
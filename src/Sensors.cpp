@@ -10,9 +10,10 @@
 #include "Ship.h"
 #include "Space.h"
 
+const double Sensors::RADAR_RANGE = 100000.0;
+
 Sensors::RadarContact::RadarContact() :
 	body(0),
-	trail(0),
 	distance(0.0),
 	iff(IFF_UNKNOWN),
 	fresh(true)
@@ -21,17 +22,17 @@ Sensors::RadarContact::RadarContact() :
 
 Sensors::RadarContact::RadarContact(Body *b) :
 	body(b),
-	trail(0),
 	distance(0.0),
 	iff(IFF_UNKNOWN),
 	fresh(true)
 {
 }
 
+Sensors::RadarContact::RadarContact(RadarContact &&other) = default;
+Sensors::RadarContact &Sensors::RadarContact::operator=(RadarContact &&other) = default;
+
 Sensors::RadarContact::~RadarContact()
 {
-	body = 0;
-	delete trail;
 }
 
 Color Sensors::IFFColor(IFF iff)
@@ -51,9 +52,10 @@ bool Sensors::ContactDistanceSort(const RadarContact &a, const RadarContact &b)
 	return a.distance < b.distance;
 }
 
-Sensors::Sensors(Ship *owner)
+Sensors::Sensors(Ship *owner) :
+	m_owner(owner),
+	m_staticContactsRevision(0)
 {
-	m_owner = owner;
 }
 
 bool Sensors::ChooseTarget(TargetingCriteria crit)
@@ -61,7 +63,9 @@ bool Sensors::ChooseTarget(TargetingCriteria crit)
 	PROFILE_SCOPED();
 	bool found = false;
 
-	m_radarContacts.sort(ContactDistanceSort);
+	std::sort(m_radarContacts.begin(), m_radarContacts.end(), ContactDistanceSort);
+	for (size_t i = 0; i < m_radarContacts.size(); i++)
+		m_contactIndex[m_radarContacts[i].body] = i;
 
 	for (auto it = m_radarContacts.begin(); it != m_radarContacts.end(); ++it) {
 		//match object type
@@ -98,76 +102,113 @@ Sensors::IFF Sensors::CheckIFF(Body *other)
 void Sensors::Update(float time)
 {
 	PROFILE_SCOPED();
-	if (m_owner != Pi::player) return;
+	const bool hasTrails = m_owner == Pi::player;
 
-	PopulateStaticContacts(); //no need to do all the time
-
-	//Find nearby contacts, same range as radar scanner. It should use these
-	//contacts, worldview labels too.
-	Space::BodyNearList nearby = Pi::game->GetSpace()->GetBodiesMaybeNear(m_owner, 100000.0f);
+	// contacts are keyed by body, so a sweep only touches the bodies the
+	// near finder returns plus the contacts that didn't show up in it
+	Space::BodyNearList nearby = Pi::game->GetSpace()->GetBodiesMaybeNear(m_owner, RADAR_RANGE);
 	for (Body *body : nearby) {
 		if (body == m_owner || !body->IsType(Object::SHIP)) continue;
 		if (body->IsDead()) continue;
 
-		auto cit = m_radarContacts.begin();
-		while (cit != m_radarContacts.end()) {
-			if (cit->body == body) break;
-			++cit;
-		}
+		const double distance = m_owner->GetPositionRelTo(body).Length();
+		if (distance > RADAR_RANGE) continue;
 
-		//create new contact or refresh old
-		if (cit == m_radarContacts.end()) {
-			m_radarContacts.push_back(RadarContact());
+		auto index = m_contactIndex.find(body);
+		if (index == m_contactIndex.end()) {
+			m_contactIndex[body] = m_radarContacts.size();
+			m_radarContacts.emplace_back(body);
 			RadarContact &rc = m_radarContacts.back();
-			rc.body = body;
-			rc.iff = CheckIFF(rc.body);
-			rc.trail = new HudTrail(rc.body, IFFColor(rc.iff));
+			rc.iff = CheckIFF(body);
+			if (hasTrails)
+				rc.trail.reset(new HudTrail(body, IFFColor(rc.iff)));
+			rc.distance = distance;
+			onContactEnter.emit(body);
 		} else {
-			cit->fresh = true;
+			RadarContact &rc = m_radarContacts[index->second];
+			rc.distance = distance;
+			rc.fresh = true;
 		}
 	}
 
 	//update contacts and delete stale ones
-	auto it = m_radarContacts.begin();
-	while (it != m_radarContacts.end()) {
-		if (!it->fresh) {
-			m_radarContacts.erase(it++);
-		} else {
-			const Ship *ship = dynamic_cast<Ship *>(it->body);
-			if (ship && Ship::FLYING == ship->GetFlightState()) {
-				it->distance = m_owner->GetPositionRelTo(it->body).Length();
-				it->trail->Update(time);
-			} else {
-				it->trail->Reset(FrameId::Invalid);
-			}
-			it->fresh = false;
-			++it;
+	for (size_t i = 0; i < m_radarContacts.size();) {
+		RadarContact &rc = m_radarContacts[i];
+		if (!rc.fresh) {
+			RemoveContact(i);
+			continue;
+		}
+		if (rc.trail) {
+			const Ship *ship = static_cast<Ship *>(rc.body);
+			if (Ship::FLYING == ship->GetFlightState())
+				rc.trail->Update(time);
+			else
+				rc.trail->Reset(FrameId::Invalid);
 		}
+		rc.fresh = false;
+		++i;
 	}
 }
 
-void Sensors::UpdateIFF(Body *b)
+void Sensors::RemoveContact(size_t index)
 {
-	PROFILE_SCOPED();
-	for (auto it = m_radarContacts.begin(); it != m_radarContacts.end(); ++it) {
-		if (it->body == b) {
-			it->iff = CheckIFF(b);
-			it->trail->SetColor(IFFColor(it->iff));
+	Body *body = m_radarContacts[index].body;
+	m_contactIndex.erase(body);
+	if (index + 1 != m_radarContacts.size()) {
+		m_radarContacts[index] = std::move(m_radarContacts.back());
+		m_contactIndex[m_radarContacts[index].body] = index;
+	}
+	m_radarContacts.pop_back();
+	onContactLeave.emit(body);
+}
+
+void Sensors::NotifyRemoved(const Body *removedBody)
+{
+	auto index = m_contactIndex.find(removedBody);
+	if (index != m_contactIndex.end())
+		RemoveContact(index->second);
+
+	for (size_t i = 0; i < m_staticContacts.size(); i++) {
+		if (m_staticContacts[i].body == removedBody) {
+			m_staticContacts.erase(m_staticContacts.begin() + i);
+			break;
 		}
 	}
 }
 
+void Sensors::UpdateIFF(Body *b)
+{
+	PROFILE_SCOPED();
+	auto index = m_contactIndex.find(b);
+	if (index == m_contactIndex.end()) return;
+
+	RadarContact &rc = m_radarContacts[index->second];
+	rc.iff = CheckIFF(b);
+	if (rc.trail)
+		rc.trail->SetColor(IFFColor(rc.iff));
+}
+
 void Sensors::ResetTrails()
 {
 	PROFILE_SCOPED();
-	for (auto it = m_radarContacts.begin(); it != m_radarContacts.end(); ++it)
-		it->trail->Reset(Pi::player->GetFrame());
+	for (RadarContact &rc : m_radarContacts)
+		if (rc.trail) rc.trail->Reset(Pi::player->GetFrame());
+}
+
+const Sensors::ContactList &Sensors::GetStaticContacts()
+{
+	// stars, planets and stations don't come and go, so only rescan the
+	// space when its body list has changed
+	if (m_staticContactsRevision != Pi::game->GetSpace()->GetBodiesRevision())
+		PopulateStaticContacts();
+	return m_staticContacts;
 }
 
 void Sensors::PopulateStaticContacts()
 {
 	PROFILE_SCOPED();
 	m_staticContacts.clear();
+	m_staticContactsRevision = Pi::game->GetSpace()->GetBodiesRevision();
 
 	for (Body *b : Pi::game->GetSpace()->GetBodies()) {
 		switch (b->GetType()) {
@@ -179,8 +220,6 @@ void Sensors::PopulateStaticContacts()
 		default:
 			continue;
 		}
-		m_staticContacts.push_back(RadarContact(b));
-		RadarContact &rc = m_staticContacts.back();
-		rc.fresh = true;
+		m_staticContacts.emplace_back(b);
 	}
 }
@@ -13,6 +13,8 @@
  */
 #include "Body.h"
 #include "libs.h"
+#include <memory>
+#include <unordered_map>
 
 class Body;
 class HudTrail;
@@ -34,15 +36,20 @@ public:
 	struct RadarContact {
 		RadarContact();
 		RadarContact(Body *);
+		RadarContact(RadarContact &&);
+		RadarContact &operator=(RadarContact &&);
 		~RadarContact();
 		Body *body;
-		HudTrail *trail;
+		std::unique_ptr<HudTrail> trail; // only the player's contacts have one
 		double distance;
 		IFF iff;
 		bool fresh;
 	};
 
-	typedef std::list<RadarContact> ContactList;
+	typedef std::vector<RadarContact> ContactList;
+
+	// ships further away than this are dropped from the contact list
+	static const double RADAR_RANGE;
 
 	static Color IFFColor(IFF);
 	static bool ContactDistanceSort(const RadarContact &a, const RadarContact &b);
@@ -51,16 +58,24 @@ public:
 	bool ChooseTarget(TargetingCriteria);
 	IFF CheckIFF(Body *other);
 	const ContactList &GetContacts() { return m_radarContacts; }
-	const ContactList &GetStaticContacts() { return m_staticContacts; }
+	const ContactList &GetStaticContacts();
 	void Update(float time);
 	void UpdateIFF(Body *);
 	void ResetTrails();
+	// the body is about to be deleted, forget about it
+	void NotifyRemoved(const Body *removedBody);
+
+	sigc::signal<void, Body *> onContactEnter;
+	sigc::signal<void, Body *> onContactLeave;
 
 private:
 	Ship *m_owner;
 	ContactList m_radarContacts;
+	std::unordered_map<const Body *, size_t> m_contactIndex; // body -> m_radarContacts index
 	ContactList m_staticContacts; //things we know of regardless of range
+	Uint32 m_staticContactsRevision;
 
+	void RemoveContact(size_t index);
 	void PopulateStaticContacts();
 };
 
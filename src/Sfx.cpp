@@ -165,12 +165,17 @@ SfxManager *SfxManager::AllocSfxInFrame(FrameId fId)
 }
 
 void SfxManager::Add(const Body *b, SFX_TYPE t)
+{
+	Add(b->GetFrame(), b->GetPosition(), b->GetVelocity(), t);
+}
+
+void SfxManager::Add(FrameId f, const vector3d &pos, const vector3d &vel, SFX_TYPE t)
 {
 	assert(t != TYPE_NONE);
-	SfxManager *sfxman = AllocSfxInFrame(b->GetFrame());
+	SfxManager *sfxman = AllocSfxInFrame(f);
 	if (!sfxman) return;
-	vector3d vel(b->GetVelocity() + 200.0 * vector3d(Pi::rng.Double() - 0.5, Pi::rng.Double() - 0.5, Pi::rng.Double() - 0.5));
-	Sfx sfx(b->GetPosition(), vel, 200, t);
+	const vector3d sfxVel(vel + 200.0 * vector3d(Pi::rng.Double() - 0.5, Pi::rng.Double() - 0.5, Pi::rng.Double() - 0.5));
+	Sfx sfx(pos, sfxVel, 200, t);
 	sfxman->AddInstance(sfx);
 }
 
@@ -52,6 +52,7 @@ public:
 	friend class Sfx;
 
 	static void Add(const Body *, SFX_TYPE);
+	static void Add(FrameId f, const vector3d &pos, const vector3d &vel, SFX_TYPE);
 	static void AddExplosion(Body *);
 	static void AddThrustSmoke(const Body *b, float speed, const vector3d &adjustpos);
 	static void TimeStepAll(const float timeStep, FrameId f);
@@ -3,6 +3,7 @@
 
 #include "EnumStrings.h"
 #include "Frame.h"
+#include "Game.h"
 #include "Pi.h"
 #include "Planet.h"
 #include "Player.h"
@@ -16,14 +17,46 @@
 #include "perlin.h"
 #include "ship/Propulsion.h"
 
+// AI level of detail. Commands of ships far from the player only re-plan
+// every few ticks, holding their thruster state in between. A command is
+// given the time that passed since it last ran as its timestep, so it spreads
+// its corrections over the whole interval like it does under time acceleration.
+static const double AI_LOD_FULL_RANGE = 100000.0;	  // 100km, every tick
+static const double AI_LOD_REDUCED_RANGE = 10000000.0; // 10000km, every 4th tick
+static const Uint32 AI_LOD_REDUCED_INTERVAL = 4;
+static const Uint32 AI_LOD_FAR_INTERVAL = 16;
+static const float AI_LOD_MAX_STEP = 1.0f; // never plan over more than a second
+
+// returns the time the ship's command should plan over
+static float ai_lod_period(const Ship *ship, float timeStep)
+{
+	if (ship == Pi::player || !Pi::player || ship->GetFlightState() != Ship::FLYING)
+		return timeStep;
+
+	// these need to react to other ships or hit a docking port exactly
+	switch (ship->GetAICommand()->GetType()) {
+	case AICommand::CMD_DOCK:
+	case AICommand::CMD_KILL:
+	case AICommand::CMD_KAMIKAZE:
+	case AICommand::CMD_FORMATION:
+		return timeStep;
+	default:
+		break;
+	}
+
+	const double dist = ship->GetPositionRelTo(Pi::player).Length();
+	const Uint32 interval = dist < AI_LOD_FULL_RANGE ? 1 : dist < AI_LOD_REDUCED_RANGE ? AI_LOD_REDUCED_INTERVAL : AI_LOD_FAR_INTERVAL;
+	return std::max(timeStep, std::min(interval * timeStep, AI_LOD_MAX_STEP));
+}
+
 // returns true if command is complete
 bool Ship::AITimeStep(float timeStep)
 {
 	// allow the launch thruster thing to happen
 	if (m_launchLockTimeout > 0.0) return false;
 
-	m_decelerating = false;
 	if (!m_curAICmd) {
+		m_decelerating = false;
 		if (this == Pi::player) return true;
 
 		// just in case the AI left it on
@@ -33,7 +66,21 @@ bool Ship::AITimeStep(float timeStep)
 		return true;
 	}
 
-	if (m_curAICmd->TimeStepUpdate()) {
+	// the elapsed time is summed tick by tick, so it stays right when the time
+	// acceleration changes part way through an interval. a ship that was just
+	// promoted runs straight away, over all the time it skipped. half a tick
+	// of slack keeps rounding from pushing a run to the next tick
+	m_aiLodTime += timeStep;
+	if (m_aiLodTime + 0.5f * timeStep < ai_lod_period(this, timeStep)) return false;
+	const float aiTimeStep = std::min(m_aiLodTime, std::max(AI_LOD_MAX_STEP, timeStep));
+	m_aiLodTime = 0.0f;
+
+	m_decelerating = false;
+	GetPropulsion()->SetAITimeStep(aiTimeStep);
+	const bool complete = m_curAICmd->TimeStepUpdate(aiTimeStep);
+	GetPropulsion()->SetAITimeStep(0.0f);
+
+	if (complete) {
 		AIClearInstructions();
 		//		ClearThrusterState();		// otherwise it does one timestep at 10k and gravity is fatal
 		LuaEvent::Queue("onAICompleted", this, EnumStrings::GetString("ShipAIError", AIMessage()));
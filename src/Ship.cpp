@@ -35,6 +35,21 @@
 #include "ship/PlayerShipController.h"
 
 static const float TONS_HULL_PER_SHIELD = 10.f;
+
+// properties that change or are read every tick are looked up by id
+static const PropertyMap::Id PROP_HULL_MASS_LEFT = PropertyMap::Intern("hullMassLeft");
+static const PropertyMap::Id PROP_HULL_PERCENT = PropertyMap::Intern("hullPercent");
+static const PropertyMap::Id PROP_SHIELD_MASS_LEFT = PropertyMap::Intern("shieldMassLeft");
+static const PropertyMap::Id PROP_FUEL_MASS_LEFT = PropertyMap::Intern("fuelMassLeft");
+static const PropertyMap::Id PROP_FUEL = PropertyMap::Intern("fuel");
+static const PropertyMap::Id PROP_FLIGHT_STATE = PropertyMap::Intern("flightState");
+static const PropertyMap::Id PROP_ALERT_STATUS = PropertyMap::Intern("alertStatus");
+static const PropertyMap::Id PROP_ATMO_SHIELD_CAP = PropertyMap::Intern("atmo_shield_cap");
+static const PropertyMap::Id PROP_FUEL_SCOOP_CAP = PropertyMap::Intern("fuel_scoop_cap");
+static const PropertyMap::Id PROP_CARGO_LIFE_SUPPORT_CAP = PropertyMap::Intern("cargo_life_support_cap");
+static const PropertyMap::Id PROP_SHIELD_ENERGY_BOOSTER_CAP = PropertyMap::Intern("shield_energy_booster_cap");
+static const PropertyMap::Id PROP_HULL_AUTOREPAIR_CAP = PropertyMap::Intern("hull_autorepair_cap");
+static const PropertyMap::Id PROP_RADAR_CAP = PropertyMap::Intern("radar_cap");
 HeatGradientParameters_t Ship::s_heatGradientParams;
 const float Ship::DEFAULT_SHIELD_COOLDOWN_TIME = 1.0f;
 const double Ship::DEFAULT_LIFT_TO_DRAG_RATIO = 0.001;
@@ -51,8 +66,8 @@ Ship::Ship(const ShipType::Id &shipId) :
 	*/
 	AddFeature(Feature::PROPULSION); // add component propulsion
 	AddFeature(Feature::FIXED_GUNS); // add component fixed guns
-	Properties().Set("flightState", EnumStrings::GetString("ShipFlightState", m_flightState));
-	Properties().Set("alertStatus", EnumStrings::GetString("ShipAlertStatus", m_alertState));
+	Properties().Set(PROP_FLIGHT_STATE, EnumStrings::GetString("ShipFlightState", m_flightState));
+	Properties().Set(PROP_ALERT_STATUS, EnumStrings::GetString("ShipAlertStatus", m_alertState));
 
 	SetFuel(1.0);
 	SetFuelReserve(0.0);
@@ -78,6 +93,7 @@ Ship::Ship(const ShipType::Id &shipId) :
 	m_ecmRecharge = 0;
 	m_shieldCooldown = 0.0f;
 	m_curAICmd = 0;
+	m_aiLodTime = 0.0f;
 	m_aiMessage = AIERROR_NONE;
 	m_decelerating = false;
 
@@ -140,8 +156,8 @@ Ship::Ship(const Json &jsonObj, Space *space) :
 		m_missileDetected = false; // alertstate check cache value
 
 		m_alertState = shipObj["alert_state"];
-		Properties().Set("flightState", EnumStrings::GetString("ShipFlightState", m_flightState));
-		Properties().Set("alertStatus", EnumStrings::GetString("ShipAlertStatus", m_alertState));
+		Properties().Set(PROP_FLIGHT_STATE, EnumStrings::GetString("ShipFlightState", m_flightState));
+		Properties().Set(PROP_ALERT_STATUS, EnumStrings::GetString("ShipAlertStatus", m_alertState));
 		m_lastFiringAlert = shipObj["last_firing_alert"];
 
 		Json hyperspaceDestObj = shipObj["hyperspace_destination"];
@@ -164,14 +180,15 @@ Ship::Ship(const Json &jsonObj, Space *space) :
 		m_shieldCooldown = shipObj["shield_cooldown"];
 		m_curAICmd = 0;
 		m_curAICmd = AICommand::LoadFromJson(shipObj);
+		m_aiLodTime = 0.0f;
 		m_aiMessage = AIError(shipObj["ai_message"]);
 
 		PropertyMap &p = Properties();
 
-		p.Set("hullMassLeft", m_stats.hull_mass_left);
-		p.Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
-		p.Set("shieldMassLeft", m_stats.shield_mass_left);
-		p.Set("fuelMassLeft", m_stats.fuel_tank_mass_left);
+		p.Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+		p.Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+		p.Set(PROP_SHIELD_MASS_LEFT, m_stats.shield_mass_left);
+		p.Set(PROP_FUEL_MASS_LEFT, m_stats.fuel_tank_mass_left);
 		p.PushLuaTable();
 		lua_State *l = Lua::manager->GetLuaState();
 		lua_getfield(l, -1, "equipSet");
@@ -216,10 +233,10 @@ void Ship::Init()
 	m_stats.shield_mass_left = 0;
 
 	PropertyMap &p = Properties();
-	p.Set("hullMassLeft", m_stats.hull_mass_left);
-	p.Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
-	p.Set("shieldMassLeft", m_stats.shield_mass_left);
-	p.Set("fuelMassLeft", m_stats.fuel_tank_mass_left);
+	p.Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+	p.Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+	p.Set(PROP_SHIELD_MASS_LEFT, m_stats.shield_mass_left);
+	p.Set(PROP_FUEL_MASS_LEFT, m_stats.fuel_tank_mass_left);
 
 	// Init of Propulsion:
 	GetPropulsion()->Init(this, GetModel(), m_type->fuelTankMass, m_type->effectiveExhaustVelocity, m_type->linThrust, m_type->angThrust, m_type->linAccelerationCap);
@@ -361,8 +378,8 @@ float Ship::GetPercentShields() const
 void Ship::SetPercentHull(float p)
 {
 	m_stats.hull_mass_left = 0.01f * Clamp(p, 0.0f, 100.0f) * float(m_type->hullMass);
-	Properties().Set("hullMassLeft", m_stats.hull_mass_left);
-	Properties().Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+	Properties().Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+	Properties().Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
 }
 
 void Ship::UpdateMass()
@@ -475,7 +492,7 @@ bool Ship::OnDamage(Object *attacker, float kgDamage, const CollisionContact &co
 				dam -= m_stats.shield_mass_left;
 				m_stats.shield_mass_left = 0;
 			}
-			Properties().Set("shieldMassLeft", m_stats.shield_mass_left);
+			Properties().Set(PROP_SHIELD_MASS_LEFT, m_stats.shield_mass_left);
 		}
 
 		m_shieldCooldown = DEFAULT_SHIELD_COOLDOWN_TIME;
@@ -487,8 +504,8 @@ bool Ship::OnDamage(Object *attacker, float kgDamage, const CollisionContact &co
 		GetShields()->AddHit(localPos);
 
 		m_stats.hull_mass_left -= dam;
-		Properties().Set("hullMassLeft", m_stats.hull_mass_left);
-		Properties().Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+		Properties().Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+		Properties().Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
 		if (m_stats.hull_mass_left < 0) {
 			if (attacker) {
 				if (attacker->IsType(Object::BODY))
@@ -598,7 +615,7 @@ bool Ship::DoDamage(float kgDamage)
 				dam -= m_stats.shield_mass_left;
 				m_stats.shield_mass_left = 0;
 			}
-			Properties().Set("shieldMassLeft", m_stats.shield_mass_left);
+			Properties().Set(PROP_SHIELD_MASS_LEFT, m_stats.shield_mass_left);
 		}
 
 		m_shieldCooldown = DEFAULT_SHIELD_COOLDOWN_TIME;
@@ -612,8 +629,8 @@ bool Ship::DoDamage(float kgDamage)
 		GetShields()->AddHit(randPos * (GetPhysRadius() * 0.75));
 
 		m_stats.hull_mass_left -= dam;
-		Properties().Set("hullMassLeft", m_stats.hull_mass_left);
-		Properties().Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+		Properties().Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+		Properties().Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
 		if (m_stats.hull_mass_left < 0) {
 			Explode();
 		} else {
@@ -729,7 +746,7 @@ void Ship::UpdateGunsStats()
 void Ship::UpdateFuelStats()
 {
 	m_stats.fuel_tank_mass_left = GetPropulsion()->FuelTankMassLeft();
-	Properties().Set("fuelMassLeft", m_stats.fuel_tank_mass_left);
+	Properties().Set(PROP_FUEL_MASS_LEFT, m_stats.fuel_tank_mass_left);
 
 	UpdateMass();
 }
@@ -851,7 +868,7 @@ void Ship::SetFlightState(Ship::FlightState newState)
 	}
 
 	m_flightState = newState;
-	Properties().Set("flightState", EnumStrings::GetString("ShipFlightState", m_flightState));
+	Properties().Set(PROP_FLIGHT_STATE, EnumStrings::GetString("ShipFlightState", m_flightState));
 
 	switch (m_flightState) {
 	case FLYING:
@@ -1059,21 +1076,21 @@ double Ship::GetHullTemperature() const
 	// TODO: fix this to properly account for heating due to air friction instead of G-force.
 	double dragGs = GetAtmosForce().Length() / (GetMass() * 9.81);
 	int atmo_shield_cap = 0;
-	const_cast<Ship *>(this)->Properties().Get(R"(atmo_shield_cap)", atmo_shield_cap);
+	const_cast<Ship *>(this)->Properties().Get(PROP_ATMO_SHIELD_CAP, atmo_shield_cap);
 	return dragGs / (15.0 * (1.0 + atmo_shield_cap + (2.0 * (1.0 - m_wheelState))));
 }
 
 void Ship::SetAlertState(AlertState as)
 {
 	m_alertState = as;
-	Properties().Set("alertStatus", EnumStrings::GetString("ShipAlertStatus", as));
+	Properties().Set(PROP_ALERT_STATUS, EnumStrings::GetString("ShipAlertStatus", as));
 }
 
 void Ship::UpdateAlertState()
 {
 	// no alerts if no radar
 	int radar_cap = 0;
-	Properties().Get("radar_cap", radar_cap);
+	Properties().Get(PROP_RADAR_CAP, radar_cap);
 	if (radar_cap <= 0) {
 		// clear existing alert state if there was one
 		if (GetAlertState() != ALERT_NONE) {
@@ -1200,7 +1217,7 @@ void Ship::UpdateFuel(const float timeStep)
 {
 	GetPropulsion()->UpdateFuel(timeStep);
 	UpdateFuelStats();
-	Properties().Set("fuel", GetFuel() * 100); // XXX to match SetFuelPercent
+	Properties().Set(PROP_FUEL, GetFuel() * 100); // XXX to match SetFuelPercent
 
 	if (GetPropulsion()->IsFuelStateChanged())
 		LuaEvent::Queue("onShipFuelChanged", this, EnumStrings::GetString("PropulsionFuelStatus", GetPropulsion()->GetFuelState()));
@@ -1230,7 +1247,7 @@ void Ship::StaticUpdate(const float timeStep)
 			p->GetAtmosphericState(dist, &pressure, &density);
 
 			int atmo_shield_cap = 0;
-			const_cast<Ship *>(this)->Properties().Get("atmo_shield_cap", atmo_shield_cap);
+			const_cast<Ship *>(this)->Properties().Get(PROP_ATMO_SHIELD_CAP, atmo_shield_cap);
 			atmo_shield_cap = std::max(atmo_shield_cap, 1); // needs to have some shielding by default
 			if (pressure > (m_type->atmosphericPressureLimit * atmo_shield_cap)) {
 				float damage = float(pressure - m_type->atmosphericPressureLimit);
@@ -1243,7 +1260,7 @@ void Ship::StaticUpdate(const float timeStep)
 
 	/* FUEL SCOOPING!!!!!!!!! */
 	int capacity = 0;
-	Properties().Get("fuel_scoop_cap", capacity);
+	Properties().Get(PROP_FUEL_SCOOP_CAP, capacity);
 	if (m_flightState == FLYING && capacity > 0) {
 		Frame *frame = Frame::GetFrame(GetFrame());
 		Body *astro = frame->GetBody();
@@ -1279,7 +1296,7 @@ void Ship::StaticUpdate(const float timeStep)
 
 	// Cargo bay life support
 	capacity = 0;
-	Properties().Get("cargo_life_support_cap", capacity);
+	Properties().Get(PROP_CARGO_LIFE_SUPPORT_CAP, capacity);
 	if (!capacity) {
 		// Hull is pressure-sealed, it just doesn't provide
 		// temperature regulation and breathable atmosphere
@@ -1351,10 +1368,10 @@ void Ship::StaticUpdate(const float timeStep)
 		// 250 second recharge
 		float recharge_rate = 0.004f;
 		float booster = 1.0f;
-		Properties().Get("shield_energy_booster_cap", booster);
+		Properties().Get(PROP_SHIELD_ENERGY_BOOSTER_CAP, booster);
 		recharge_rate *= booster;
 		m_stats.shield_mass_left = Clamp(m_stats.shield_mass_left + m_stats.shield_mass * recharge_rate * timeStep, 0.0f, m_stats.shield_mass);
-		Properties().Set("shieldMassLeft", m_stats.shield_mass_left);
+		Properties().Set(PROP_SHIELD_MASS_LEFT, m_stats.shield_mass_left);
 	}
 
 	if (m_wheelTransition) {
@@ -1367,11 +1384,11 @@ void Ship::StaticUpdate(const float timeStep)
 	if (m_testLanded) TestLanded();
 
 	capacity = 0;
-	Properties().Get("hull_autorepair_cap", capacity);
+	Properties().Get(PROP_HULL_AUTOREPAIR_CAP, capacity);
 	if (capacity) {
 		m_stats.hull_mass_left = std::min(m_stats.hull_mass_left + 0.1f * timeStep, float(m_type->hullMass));
-		Properties().Set("hullMassLeft", m_stats.hull_mass_left);
-		Properties().Set("hullPercent", 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
+		Properties().Set(PROP_HULL_MASS_LEFT, m_stats.hull_mass_left);
+		Properties().Set(PROP_HULL_PERCENT, 100.0f * (m_stats.hull_mass_left / float(m_type->hullMass)));
 	}
 
 	// After calling StartHyperspaceTo this Ship must not spawn objects
@@ -1419,6 +1436,7 @@ void Ship::StaticUpdate(const float timeStep)
 void Ship::NotifyRemoved(const Body *const removedBody)
 {
 	if (m_curAICmd) m_curAICmd->OnDeleted(removedBody);
+	if (m_sensors.get()) m_sensors->NotifyRemoved(removedBody);
 }
 
 bool Ship::Undock()
@@ -304,6 +304,8 @@ private:
 	HyperspaceCloud *m_hyperspaceCloud;
 
 	AICommand *m_curAICmd;
+	// AI level of detail: game time since the command last ran
+	float m_aiLodTime;
 
 	double m_landingMinOffset; // offset from the centre of the ship used during docking
 
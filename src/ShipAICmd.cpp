@@ -78,11 +78,11 @@ void AICommand::PostLoadFixup(Space *space)
 	if (m_child) m_child->PostLoadFixup(space);
 }
 
-bool AICommand::ProcessChild()
+bool AICommand::ProcessChild(float timeStep)
 {
 	if (!m_child) return true; // no child present
 	m_child->m_is_flyto = false;
-	if (!m_child->TimeStepUpdate()) return false; // child still active
+	if (!m_child->TimeStepUpdate(timeStep)) return false; // child still active
 	m_child.reset();
 	return true; // child finished
 }
@@ -260,7 +260,7 @@ void AICmdKamikaze::PostLoadFixup(Space *space)
 	assert(m_prop != nullptr);
 }
 
-bool AICmdKamikaze::TimeStepUpdate()
+bool AICmdKamikaze::TimeStepUpdate(float timeStep)
 {
 	if (!m_target || m_target->IsDead()) return true;
 
@@ -362,7 +362,7 @@ void AICmdKill::PostLoadFixup(Space *space)
 	assert(m_fguns != nullptr);
 }
 
-bool AICmdKill::TimeStepUpdate()
+bool AICmdKill::TimeStepUpdate(float timeStep)
 {
 	if (m_dBody->IsType(Object::SHIP)) {
 		Ship *ship = static_cast<Ship *>(m_dBody);
@@ -379,7 +379,7 @@ bool AICmdKill::TimeStepUpdate()
 		return false;
 	}
 
-	if (!ProcessChild()) return false;
+	if (!ProcessChild(timeStep)) return false;
 	if (!m_target || m_target->IsDead()) return true;
 
 	const matrix3x3d &rot = m_dBody->GetOrient();
@@ -388,14 +388,14 @@ bool AICmdKill::TimeStepUpdate()
 	vector3d targdir = targpos.NormalizedSafe();
 	vector3d heading = -rot.VectorZ();
 	// Accel will be wrong for a frame on timestep changes, but it doesn't matter
-	vector3d targaccel = (m_target->GetVelocity() - m_lastVel) / Pi::game->GetTimeStep();
+	vector3d targaccel = (m_target->GetVelocity() - m_lastVel) / timeStep;
 	m_lastVel = m_target->GetVelocity(); // may need next frame
 	vector3d leaddir = m_prop->AIGetLeadDir(m_target, targaccel, m_fguns->GetProjSpeed(0));
 
 	if (targpos.Length() >= VICINITY_MIN + 1000.0) { // if really far from target, intercept
 		//		Output("%s started AUTOPILOT\n", m_ship->GetLabel().c_str());
 		m_child.reset(new AICmdFlyTo(m_dBody, m_target));
-		ProcessChild();
+		ProcessChild(timeStep);
 		return false;
 	}
 
@@ -428,7 +428,7 @@ bool AICmdKill::TimeStepUpdate()
 		max_fire_dist *= max_fire_dist;
 		if (targpos.LengthSqr() > max_fire_dist) m_fguns->SetGunFiringState(0, 0); // temp
 	}
-	m_leadOffset += m_leadDrift * Pi::game->GetTimeStep();
+	m_leadOffset += m_leadDrift * timeStep;
 	double leadAV = (leaddir - targdir).Dot((leaddir - heading).NormalizedSafe()); // leaddir angvel
 	m_prop->AIFaceDirection((leaddir + m_leadOffset).Normalized(), leadAV);
 
@@ -832,7 +832,7 @@ static bool CheckSuicide(DynamicBody *dBody, const vector3d &tandir)
 	return false;
 }
 
-extern double calc_ivel(double dist, double vel, double acc);
+extern double calc_ivel(double dist, double vel, double acc, double timeStep);
 
 void AICmdFlyTo::OnDeleted(const Body *body)
 {
@@ -942,7 +942,7 @@ void AICmdFlyTo::SaveToJson(Json &jsonObj)
 	jsonObj["ai_command"] = aiCommandObj; // Add ai command object to supplied object.
 }
 
-bool AICmdFlyTo::TimeStepUpdate()
+bool AICmdFlyTo::TimeStepUpdate(float timeStep)
 {
 	/* TODO: ship is used ONLY to calls
 	 * wheels, launch and flightstate, so
@@ -966,7 +966,7 @@ bool AICmdFlyTo::TimeStepUpdate()
 	if (!m_target && !m_targframeId.valid()) return true; // deleted object
 
 	// generate base target pos (with vicinity adjustment) & vel
-	double timestep = Pi::game->GetTimeStep();
+	double timestep = timeStep;
 	vector3d targpos, targvel;
 	if (m_target) {
 		targpos = m_target->GetPositionRelTo(m_dBody->GetFrame());
@@ -1016,7 +1016,7 @@ bool AICmdFlyTo::TimeStepUpdate()
 		} else { // same thing for 2/3/4
 			if (!m_child) m_child.reset(new AICmdFlyAround(m_dBody, Frame::GetFrame(m_frameId)->GetBody(), erad * 1.05, 0.0));
 			static_cast<AICmdFlyAround *>(m_child.get())->SetTargPos(targpos);
-			ProcessChild();
+			ProcessChild(timeStep);
 		}
 		if (coll) {
 			m_state = -coll;
@@ -1067,7 +1067,7 @@ bool AICmdFlyTo::TimeStepUpdate()
 	//	if (perpspeed < tt*0.01*m_ship->GetAccelMin()) perpspeed = 0;
 
 	// calculate target speed
-	double ispeed = (maxdecel < 1e-10) ? 0.0 : calc_ivel(targdist, m_endvel, maxdecel);
+	double ispeed = (maxdecel < 1e-10) ? 0.0 : calc_ivel(targdist, m_endvel, maxdecel, timeStep);
 
 	// cap target speed according to spare fuel remaining
 	double fuelspeed = m_prop->GetSpeedReachedWithFuel();
@@ -1212,10 +1212,10 @@ void AICmdDock::SaveToJson(Json &jsonObj)
 // 2: get data for docking end pos
 // 3: Fly to docking end pos
 
-bool AICmdDock::TimeStepUpdate()
+bool AICmdDock::TimeStepUpdate(float timeStep)
 {
 	Ship *ship = nullptr;
-	if (!ProcessChild()) return false;
+	if (!ProcessChild(timeStep)) return false;
 	if (!m_target) return true;
 
 	if (!m_dBody->IsType(Object::SHIP)) return false;
@@ -1249,7 +1249,7 @@ bool AICmdDock::TimeStepUpdate()
 	double targdist = m_target->GetPositionRelTo(ship).LengthSqr();
 	if (targdist > 16000.0 * 16000.0) {
 		m_child.reset(new AICmdFlyTo(m_dBody, m_target));
-		ProcessChild();
+		ProcessChild(timeStep);
 		return false;
 	}
 
@@ -1290,7 +1290,7 @@ bool AICmdDock::TimeStepUpdate()
 
 	if (m_state == eDockFlyToStart) { // fly to first docking waypoint
 		m_child.reset(new AICmdFlyTo(m_dBody, m_target->GetFrame(), m_dockpos, 0.0, false));
-		ProcessChild();
+		ProcessChild(timeStep);
 		return false;
 	}
 
@@ -1302,7 +1302,7 @@ bool AICmdDock::TimeStepUpdate()
 	const vector3d relvel = -m_target->GetVelocityRelTo(m_dBody);
 
 	const double maxdecel = m_prop->GetAccelUp() - GetGravityAtPos(m_target->GetFrame(), m_dockpos);
-	const double ispeed = calc_ivel(relpos.Length(), 0.0, maxdecel);
+	const double ispeed = calc_ivel(relpos.Length(), 0.0, maxdecel, timeStep);
 	const vector3d vdiff = ispeed * reldir - relvel;
 	m_prop->AIChangeVelDir(vdiff * m_dBody->GetOrient());
 	if (vdiff.Dot(reldir) < 0) {
@@ -1312,7 +1312,7 @@ bool AICmdDock::TimeStepUpdate()
 	// get rotation of station for next frame
 	matrix3x3d trot = m_target->GetOrientRelTo(m_dBody->GetFrame());
 	double av = m_target->GetAngVelocity().Length();
-	double ang = av * Pi::game->GetTimeStep();
+	double ang = av * timeStep;
 	if (ang > 1e-16) {
 		vector3d axis = m_target->GetAngVelocity().Normalized();
 		trot = trot * matrix3x3d::Rotate(ang, axis);
@@ -1353,7 +1353,7 @@ AICmdHoldPosition::AICmdHoldPosition(const Json &jsonObj) :
 	assert(m_prop != nullptr);
 }
 
-bool AICmdHoldPosition::TimeStepUpdate()
+bool AICmdHoldPosition::TimeStepUpdate(float timeStep)
 {
 	// XXX perhaps try harder to move back to the original position
 	m_prop->AIMatchVel(vector3d(0, 0, 0));
@@ -1451,7 +1451,7 @@ void AICmdFlyAround::SaveToJson(Json &jsonObj)
 	jsonObj["ai_command"] = aiCommandObj; // Add ai command object to supplied object.
 }
 
-double AICmdFlyAround::MaxVel(double targdist, double targalt)
+double AICmdFlyAround::MaxVel(double targdist, double targalt, float timeStep)
 {
 	Propulsion *prop = m_dBody->GetPropulsion();
 	assert(prop != 0);
@@ -1460,11 +1460,11 @@ double AICmdFlyAround::MaxVel(double targdist, double targalt)
 	double t = sqrt(2.0 * targdist / prop->GetAccelFwd());
 	double vmaxprox = prop->GetAccelMin() * t; // limit by target proximity
 	double vmaxstep = std::max(m_alt * 0.05, m_alt - targalt);
-	vmaxstep /= Pi::game->GetTimeStep(); // limit by distance covered per timestep
+	vmaxstep /= timeStep; // limit by distance covered per timestep
 	return std::min(m_vel, std::min(vmaxprox, vmaxstep));
 }
 
-bool AICmdFlyAround::TimeStepUpdate()
+bool AICmdFlyAround::TimeStepUpdate(float timeStep)
 {
 	if (m_dBody->IsType(Object::SHIP)) {
 		Ship *ship = nullptr;
@@ -1472,7 +1472,7 @@ bool AICmdFlyAround::TimeStepUpdate()
 		assert(ship != 0);
 
 		if (ship->GetFlightState() == Ship::JUMPING) return false;
-		if (!ProcessChild()) return false;
+		if (!ProcessChild(timeStep)) return false;
 
 		// Not necessary unless it's a tier 1 AI
 		if (ship->GetFlightState() == Ship::FLYING)
@@ -1486,7 +1486,7 @@ bool AICmdFlyAround::TimeStepUpdate()
 		// return false;
 	}
 
-	double timestep = Pi::game->GetTimeStep();
+	double timestep = timeStep;
 	vector3d targpos = (!m_targmode) ? m_targpos :
 									   m_dBody->GetVelocity().NormalizedSafe() * m_dBody->GetPosition().LengthSqr();
 	vector3d obspos = m_obstructor->GetPositionRelTo(m_dBody);
@@ -1512,14 +1512,14 @@ bool AICmdFlyAround::TimeStepUpdate()
 		else if (relpos.LengthSqr() < obsdist + tpos_obs.LengthSqr())
 			v = 0.0;
 		else
-			v = MaxVel((tpos_obs - tangent).Length(), tpos_obs.Length());
+			v = MaxVel((tpos_obs - tangent).Length(), tpos_obs.Length(), timeStep);
 		m_child.reset(new AICmdFlyTo(m_dBody, obsframeId, tangent, v, true));
-		ProcessChild();
+		ProcessChild(timeStep);
 		return false;
 	}
 
 	// limit m_vel by target proximity & distance covered per frame
-	double vel = (m_targmode) ? m_vel : MaxVel(relpos.Length(), targpos.Length());
+	double vel = (m_targmode) ? m_vel : MaxVel(relpos.Length(), targpos.Length(), timeStep);
 
 	// all calculations in ship's frame
 	vector3d fwddir = (obsdir.Cross(relpos).Cross(obsdir)).NormalizedSafe();
@@ -1534,7 +1534,7 @@ bool AICmdFlyAround::TimeStepUpdate()
 
 	// calculate target velocity
 	double alt = (tanvel * timestep + obspos).Length(); // unnecessary?
-	double ivel = calc_ivel(alt - m_alt, 0.0, m_prop->GetAccelMin());
+	double ivel = calc_ivel(alt - m_alt, 0.0, m_prop->GetAccelMin(), timeStep);
 
 	vector3d finalvel = tanvel + ivel * obsdir;
 	m_prop->AIMatchVel(finalvel);
@@ -1611,7 +1611,7 @@ void AICmdFormation::PostLoadFixup(Space *space)
 	assert(m_prop != nullptr);
 }
 
-bool AICmdFormation::TimeStepUpdate()
+bool AICmdFormation::TimeStepUpdate(float timeStep)
 {
 	if (m_dBody->IsType(Object::SHIP)) {
 		Ship *ship = static_cast<Ship *>(m_dBody);
@@ -1626,13 +1626,13 @@ bool AICmdFormation::TimeStepUpdate()
 		}
 	}
 	if (!m_target) return true;
-	if (!ProcessChild()) return false; // In case we're doing an intercept
+	if (!ProcessChild(timeStep)) return false; // In case we're doing an intercept
 
 	// if too far away, do an intercept first
 	// TODO: adjust distance cap by timestep so we don't bounce?
 	if (m_target->GetPositionRelTo(m_dBody).Length() > 30000.0) {
 		m_child.reset(new AICmdFlyTo(m_dBody, m_target));
-		ProcessChild();
+		ProcessChild(timeStep);
 		return false;
 	}
 
@@ -1645,12 +1645,12 @@ bool AICmdFormation::TimeStepUpdate()
 	// adjust for target acceleration
 	matrix3x3d forient = Frame::GetFrame(m_target->GetFrame())->GetOrientRelTo(m_dBody->GetFrame());
 	vector3d targaccel = forient * m_target->GetLastForce() / m_target->GetMass();
-	relvel -= targaccel * Pi::game->GetTimeStep();
+	relvel -= targaccel * timeStep;
 	double maxdecel = m_prop->GetAccelFwd() + targaccel.Dot(reldir);
 	if (maxdecel < 0.0) maxdecel = 0.0;
 
 	// linear thrust
-	double ispeed = calc_ivel(targdist, 0.0, maxdecel);
+	double ispeed = calc_ivel(targdist, 0.0, maxdecel, timeStep);
 	vector3d vdiff = ispeed * reldir - relvel;
 	m_prop->AIChangeVelDir(vdiff * m_dBody->GetOrient());
 	if (m_target->IsType(Object::SHIP)) {
@@ -38,8 +38,10 @@ public:
 	}
 	virtual ~AICommand() {}
 
-	virtual bool TimeStepUpdate() = 0;
-	bool ProcessChild(); // returns false if child is active
+	// timeStep is the time the command plans over, which can span several
+	// physics ticks for distant ships, see Ship::AITimeStep
+	virtual bool TimeStepUpdate(float timeStep) = 0;
+	bool ProcessChild(float timeStep); // returns false if child is active
 	virtual void GetStatusText(char *str)
 	{
 		if (m_child)
@@ -76,7 +78,7 @@ protected:
 
 class AICmdDock : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdDock(DynamicBody *dBody, SpaceStation *target);
 
 	virtual void GetStatusText(char *str);
@@ -118,7 +120,7 @@ private:
 
 class AICmdFlyTo : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdFlyTo(DynamicBody *dBody, FrameId targframeId, const vector3d &posoff, double endvel, bool tangent);
 	AICmdFlyTo(DynamicBody *dBody, Body *target);
 
@@ -146,7 +148,7 @@ private:
 
 class AICmdFlyAround : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdFlyAround(DynamicBody *dBody, Body *obstructor, double relalt, int mode = 2);
 	AICmdFlyAround(DynamicBody *dBody, Body *obstructor, double alt, double vel, int mode = 1);
 
@@ -167,7 +169,7 @@ public:
 
 protected:
 	void Setup(Body *obstructor, double alt, double vel, int mode);
-	double MaxVel(double targdist, double targalt);
+	double MaxVel(double targdist, double targalt, float timeStep);
 
 private:
 	Body *m_obstructor; // body to fly around
@@ -179,7 +181,7 @@ private:
 
 class AICmdKill : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdKill(DynamicBody *dBody, Ship *target);
 	AICmdKill(const Json &jsonObj);
 
@@ -200,7 +202,7 @@ private:
 
 class AICmdKamikaze : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdKamikaze(DynamicBody *dBody, Body *target);
 
 	virtual void SaveToJson(Json &jsonObj);
@@ -216,14 +218,14 @@ private:
 
 class AICmdHoldPosition : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdHoldPosition(DynamicBody *dBody);
 	AICmdHoldPosition(const Json &jsonObj);
 };
 
 class AICmdFormation : public AICommand {
 public:
-	virtual bool TimeStepUpdate();
+	virtual bool TimeStepUpdate(float timeStep);
 	AICmdFormation(DynamicBody *dBody, DynamicBody *target, const vector3d &posoff);
 
 	void GetStatusText(char *str);
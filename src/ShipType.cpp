@@ -356,7 +356,8 @@ int _define_ship(lua_State *L, ShipType::Tag tag, std::vector<ShipType::Id> *lis
 	const std::string saveMe = writer.write(data);
 
 	const std::string path("ships/" + s_currentShipFile + ".json");
-	FileSystem::FileSourceFS newFS(FileSystem::GetDataDir());
+	FileSystem::FileSourceFS newFS(FileSystem::GetDataWriteDir());
+	newFS.MakeDirectory("ships");
 	FILE *f = newFS.OpenWriteStream(path);
 	if (!f) {
 		Output("couldn't open file for writing '%s'\n", path.c_str());
@@ -14,6 +14,7 @@
 #include "Pi.h"
 #include "Planet.h"
 #include "Player.h"
+#include "Projectile.h"
 #include "SpaceStation.h"
 #include "Star.h"
 #include "SystemView.h"
@@ -28,14 +29,28 @@
 
 //#define DEBUG_CACHE
 
+static Uint32 s_bodiesRevision = 0;
+
+constexpr double Space::BodyNearFinder::GRID_CELL_SIZE;
+
+Uint64 Space::BodyNearFinder::GridCellKey(Sint64 x, Sint64 y, Sint64 z)
+{
+	return (Uint64(x) * 0x9E3779B97F4A7C15ULL) ^ (Uint64(y) * 0xC2B2AE3D27D4EB4FULL) ^ (Uint64(z) * 0x165667B19E3779F9ULL);
+}
+
 void Space::BodyNearFinder::Prepare()
 {
 	m_bodyDist.clear();
+	m_bodyCells.clear();
 
-	for (Body *b : m_space->GetBodies())
-		m_bodyDist.emplace_back(b, b->GetPositionRelTo(m_space->GetRootFrame()).Length());
+	for (Body *b : m_space->GetBodies()) {
+		const vector3d pos = b->GetPositionRelTo(m_space->GetRootFrame());
+		m_bodyDist.emplace_back(b, pos.Length());
+		m_bodyCells.emplace_back(b, GridCellKey(Sint64(floor(pos.x / GRID_CELL_SIZE)), Sint64(floor(pos.y / GRID_CELL_SIZE)), Sint64(floor(pos.z / GRID_CELL_SIZE))));
+	}
 
 	std::sort(m_bodyDist.begin(), m_bodyDist.end());
+	std::sort(m_bodyCells.begin(), m_bodyCells.end());
 }
 
 Space::BodyNearList Space::BodyNearFinder::GetBodiesMaybeNear(const Body *b, double dist)
@@ -50,6 +65,30 @@ Space::BodyNearList Space::BodyNearFinder::GetBodiesMaybeNear(const vector3d &po
 		return std::move(m_nearBodies);
 	}
 
+	if (dist <= GRID_CELL_SIZE) {
+		const Sint64 cx = Sint64(floor(pos.x / GRID_CELL_SIZE));
+		const Sint64 cy = Sint64(floor(pos.y / GRID_CELL_SIZE));
+		const Sint64 cz = Sint64(floor(pos.z / GRID_CELL_SIZE));
+
+		Uint64 keys[27];
+		Uint64 *end = keys;
+		for (Sint64 x = cx - 1; x <= cx + 1; x++)
+			for (Sint64 y = cy - 1; y <= cy + 1; y++)
+				for (Sint64 z = cz - 1; z <= cz + 1; z++)
+					*end++ = GridCellKey(x, y, z);
+		// colliding keys would return the same bodies twice
+		std::sort(keys, end);
+		end = std::unique(keys, end);
+
+		m_nearBodies.clear();
+		for (const Uint64 *key = keys; key != end; ++key) {
+			auto range = std::equal_range(m_bodyCells.cbegin(), m_bodyCells.cend(), *key);
+			std::for_each(range.first, range.second, [&](BodyCell const &bc) { m_nearBodies.push_back(bc.body); });
+		}
+
+		return std::move(m_nearBodies);
+	}
+
 	const double len = pos.Length();
 
 	std::vector<BodyDist>::const_iterator min = std::lower_bound(m_bodyDist.begin(), m_bodyDist.end(), len - dist);
@@ -66,9 +105,11 @@ Space::BodyNearList Space::BodyNearFinder::GetBodiesMaybeNear(const vector3d &po
 Space::Space(Game *game, RefCountedPtr<Galaxy> galaxy, Space *oldSpace) :
 	m_starSystemCache(oldSpace ? oldSpace->m_starSystemCache : galaxy->NewStarSystemSlaveCache()),
 	m_game(game),
+	m_bodiesRevision(++s_bodiesRevision),
 	m_bodyIndexValid(false),
 	m_sbodyIndexValid(false),
-	m_bodyNearFinder(this)
+	m_bodyNearFinder(this),
+	m_projectiles(new ProjectileManager)
 #ifndef NDEBUG
 	,
 	m_processingFinalizationQueue(false)
@@ -85,9 +126,11 @@ Space::Space(Game *game, RefCountedPtr<Galaxy> galaxy, const SystemPath &path, S
 	m_starSystemCache(oldSpace ? oldSpace->m_starSystemCache : galaxy->NewStarSystemSlaveCache()),
 	m_starSystem(galaxy->GetStarSystem(path)),
 	m_game(game),
+	m_bodiesRevision(++s_bodiesRevision),
 	m_bodyIndexValid(false),
 	m_sbodyIndexValid(false),
-	m_bodyNearFinder(this)
+	m_bodyNearFinder(this),
+	m_projectiles(new ProjectileManager)
 #ifndef NDEBUG
 	,
 	m_processingFinalizationQueue(false)
@@ -111,9 +154,11 @@ Space::Space(Game *game, RefCountedPtr<Galaxy> galaxy, const SystemPath &path, S
 Space::Space(Game *game, RefCountedPtr<Galaxy> galaxy, const Json &jsonObj, double at_time) :
 	m_starSystemCache(galaxy->NewStarSystemSlaveCache()),
 	m_game(game),
+	m_bodiesRevision(++s_bodiesRevision),
 	m_bodyIndexValid(false),
 	m_sbodyIndexValid(false),
-	m_bodyNearFinder(this)
+	m_bodyNearFinder(this),
+	m_projectiles(new ProjectileManager)
 #ifndef NDEBUG
 	,
 	m_processingFinalizationQueue(false)
@@ -145,6 +190,8 @@ Space::Space(Game *game, RefCountedPtr<Galaxy> galaxy, const Json &jsonObj, doub
 
 	RebuildBodyIndex();
 
+	m_projectiles->FromJson(spaceObj, this);
+
 	Frame::PostUnserializeFixup(m_rootFrameId, this);
 	for (Body *b : m_bodies)
 		b->PostLoadFixup(this);
@@ -193,6 +240,8 @@ void Space::ToJson(Json &jsonObj)
 	}
 	spaceObj["bodies"] = bodyArray; // Add body array to space object.
 
+	m_projectiles->ToJson(spaceObj, this);
+
 	jsonObj["space"] = spaceObj; // Add space object to supplied object.
 }
 
@@ -271,6 +320,7 @@ void Space::RebuildSystemBodyIndex()
 void Space::AddBody(Body *b)
 {
 	m_bodies.push_back(b);
+	m_bodiesRevision = ++s_bodiesRevision;
 }
 
 void Space::RemoveBody(Body *b)
@@ -970,11 +1020,18 @@ void Space::TimeStep(float step)
 
 	m_bodyIndexValid = m_sbodyIndexValid = false;
 
+	Profiler::Clock phase;
+	phase.Start();
+
 	Frame::CollideFrames(&hitCallback);
 
 	for (Body *b : m_bodies)
 		CollideWithTerrain(b, step);
 
+	phase.SoftStop();
+	m_timeStepStats.collisions = phase.milliseconds();
+	phase.SoftReset();
+
 	// update frames of reference
 	for (Body *b : m_bodies)
 		b->UpdateFrame();
@@ -982,18 +1039,31 @@ void Space::TimeStep(float step)
 	// AI acts here, then move all bodies and frames
 	for (Body *b : m_bodies)
 		b->StaticUpdate(step);
+	m_projectiles->StaticUpdate(step);
 
 	Frame::UpdateOrbitRails(m_game->GetTime(), m_game->GetTimeStep());
 
 	for (Body *b : m_bodies)
 		b->TimeStepUpdate(step);
+	m_projectiles->TimeStepUpdate(step);
+
+	phase.SoftStop();
+	m_timeStepStats.dynamics = phase.milliseconds();
+	phase.SoftReset();
 
 	LuaEvent::Emit();
 	Pi::luaTimer->Tick();
 
+	phase.SoftStop();
+	m_timeStepStats.lua = phase.milliseconds();
+	phase.SoftReset();
+
 	UpdateBodies();
 
 	m_bodyNearFinder.Prepare();
+
+	phase.SoftStop();
+	m_timeStepStats.bodies = phase.milliseconds();
 }
 
 void Space::UpdateBodies()
@@ -1002,10 +1072,14 @@ void Space::UpdateBodies()
 	m_processingFinalizationQueue = true;
 #endif
 
+	if (!m_removeBodies.empty() || !m_killBodies.empty())
+		m_bodiesRevision = ++s_bodiesRevision;
+
 	for (Body *rmb : m_removeBodies) {
 		rmb->SetFrame(FrameId::Invalid);
 		for (Body *b : m_bodies)
 			b->NotifyRemoved(rmb);
+		m_projectiles->NotifyRemoved(rmb);
 		if (Pi::GetView()) Pi::game->GetSystemView()->BodyInaccessible(rmb);
 		m_bodies.remove(rmb);
 	}
@@ -1014,6 +1088,7 @@ void Space::UpdateBodies()
 	for (Body *killb : m_killBodies) {
 		for (Body *b : m_bodies)
 			b->NotifyRemoved(killb);
+		m_projectiles->NotifyRemoved(killb);
 		if (Pi::GetView()) Pi::game->GetSystemView()->BodyInaccessible(killb);
 		m_bodies.remove(killb);
 		delete killb;
@@ -16,6 +16,7 @@
 class Body;
 class Frame;
 class Game;
+class ProjectileManager;
 
 class Space {
 public:
@@ -50,6 +51,15 @@ public:
 
 	void TimeStep(float step);
 
+	// wall clock time spent in each phase of the last TimeStep, in milliseconds
+	struct TimeStepStats {
+		double collisions = 0.0; // frame and terrain collisions
+		double dynamics = 0.0;	 // frame updates, AI, orbit rails and integration
+		double lua = 0.0;		 // queued events and timers
+		double bodies = 0.0;	 // body removal and the near finder
+	};
+	const TimeStepStats &GetTimeStepStats() const { return m_timeStepStats; }
+
 	void GetHyperspaceExitParams(const SystemPath &source, const SystemPath &dest,
 		vector3d &pos, vector3d &vel) const;
 	vector3d GetHyperspaceExitPoint(const SystemPath &source, const SystemPath &dest) const
@@ -67,10 +77,14 @@ public:
 	Body *FindBodyForPath(const SystemPath *path) const;
 
 	Uint32 GetNumBodies() const { return static_cast<Uint32>(m_bodies.size()); }
+	// changes whenever a body is added to or removed from this (or any) space,
+	// for caches derived from the body list
+	Uint32 GetBodiesRevision() const { return m_bodiesRevision; }
 	IterationProxy<std::list<Body *>> GetBodies() { return MakeIterationProxy(m_bodies); }
 	const IterationProxy<const std::list<Body *>> GetBodies() const { return MakeIterationProxy(m_bodies); }
 
 	Background::Container *GetBackground() { return m_background.get(); }
+	ProjectileManager *GetProjectiles() { return m_projectiles.get(); }
 	void RefreshBackground();
 
 	// body finder delegates
@@ -108,6 +122,8 @@ private:
 	// all the bodies we know about
 	std::list<Body *> m_bodies;
 
+	Uint32 m_bodiesRevision;
+
 	// bodies that were removed/killed this timestep and need pruning at the end
 	std::list<Body *> m_removeBodies;
 	std::list<Body *> m_killBodies;
@@ -135,6 +151,28 @@ private:
 		BodyNearList GetBodiesMaybeNear(const vector3d &pos, double dist);
 
 	private:
+		// short range queries (sensors, ECM, missiles, collision alerts) look
+		// in the 3x3x3 block of grid cells around the query point, anything
+		// longer falls back to the shells of equal distance from the root
+		static constexpr double GRID_CELL_SIZE = 100000.0;
+
+		// cells are stored by a hash of their coordinates, a collision only
+		// means a query returns a few more bodies than it needs to
+		static Uint64 GridCellKey(Sint64 x, Sint64 y, Sint64 z);
+
+		struct BodyCell {
+			BodyCell(Body *_body, Uint64 _cell) :
+				body(_body),
+				cell(_cell) {}
+			Body *body;
+			Uint64 cell;
+
+			bool operator<(const BodyCell &a) const { return cell < a.cell; }
+
+			friend bool operator<(const BodyCell &a, Uint64 c) { return a.cell < c; }
+			friend bool operator<(Uint64 c, const BodyCell &a) { return c < a.cell; }
+		};
+
 		struct BodyDist {
 			BodyDist(Body *_body, double _dist) :
 				body(_body),
@@ -150,11 +188,17 @@ private:
 
 		const Space *m_space;
 		std::vector<BodyDist> m_bodyDist;
+		std::vector<BodyCell> m_bodyCells;
 		std::vector<Body *> m_nearBodies;
 	};
 
 	BodyNearFinder m_bodyNearFinder;
 
+	// laser bolts and beams, which are not bodies
+	std::unique_ptr<ProjectileManager> m_projectiles;
+
+	TimeStepStats m_timeStepStats;
+
 #ifndef NDEBUG
 	//to check RemoveBody and KillBody are not called from within
 	//the NotifyRemoved callback (#735)
@@ -0,0 +1,97 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "Benchmark.h"
+#include "Pi.h"
+#include "utils.h"
+#include <SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void PrintUsage()
+{
+	printf(
+		"pioneer-bench - Run the game headless through scripted scenarios and time it.\n"
+		"USAGE: pioneer-bench [-steps N] [-o output.json] [scenario...] [key=value...]\n"
+		"  -steps N   run every scenario for N steps instead of its default\n"
+		"  -o file    write the timings to file, - for stdout (default benchmark.json)\n"
+#ifdef PIONEER_PROFILER
+		"  -trace file  record a Chrome trace of the last frames of the run to file\n"
+#endif
+		"  key=value  override a config option, as for pioneer\n"
+		"scenarios (default all):");
+	for (const std::string &name : Benchmark::GetScenarioNames())
+		printf(" %s", name.c_str());
+	printf("\n");
+}
+
+extern "C" int main(int argc, char **argv)
+{
+#ifdef PIONEER_PROFILER
+	Profiler::detect(argc, argv);
+#endif
+
+	int steps = 0;
+	std::string outFile = "benchmark.json";
+	std::string traceFile;
+	std::vector<std::string> scenarios;
+
+	// no window, no audio, and nothing that would be written back to the config
+	std::map<std::string, std::string> options;
+	options["RendererName"] = "Dummy";
+	options["DisableSound"] = "1";
+	options["EnableGPUJobs"] = "0";
+	options["VSync"] = "0";
+
+	for (int i = 1; i < argc; i++) {
+		const std::string arg(argv[i]);
+		if (arg == "-steps" && i + 1 < argc) {
+			steps = atoi(argv[++i]);
+			if (steps <= 0) {
+				printf("Invalid step count %s.\n", argv[i]);
+				return 1;
+			}
+		} else if (arg == "-o" && i + 1 < argc) {
+			outFile = argv[++i];
+			if (outFile == "-")
+				outFile.clear();
+#ifdef PIONEER_PROFILER
+		} else if (arg == "-trace" && i + 1 < argc) {
+			traceFile = argv[++i];
+#endif
+		} else if (arg.find('=') != std::string::npos) {
+			std::vector<std::string> keyValue = SplitString(arg, "=");
+			if (keyValue.size() != 2 || keyValue[0].empty() || keyValue[1].empty()) {
+				printf("Malformed option %s.\n", arg.c_str());
+				return 1;
+			}
+			options[keyValue[0]] = keyValue[1];
+		} else if (Benchmark::HasScenario(arg)) {
+			scenarios.push_back(arg);
+		} else {
+			PrintUsage();
+			return arg == "-h" || arg == "-help" ? 0 : 1;
+		}
+	}
+
+	// SDL still wants a video driver for input and timing, unless one was asked for
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+	Pi::Init(options, true);
+	Pi::GetApp()->SetBenchmark(std::make_shared<Benchmark>(scenarios, steps, outFile));
+
+#ifdef PIONEER_PROFILER
+	if (!traceFile.empty())
+		Profiler::tracestart();
+#endif
+
+	Pi::GetApp()->Run();
+
+#ifdef PIONEER_PROFILER
+	if (!traceFile.empty() && !Profiler::tracewrite(traceFile.c_str()))
+		printf("Could not write trace to %s.\n", traceFile.c_str());
+#endif
+
+	return 0;
+}
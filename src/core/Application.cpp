@@ -130,6 +130,10 @@ void Application::Run()
 		if (!m_activeLifecycle)
 			break;
 
+#ifdef PIONEER_PROFILER
+		Profiler::traceframe();
+#endif
+
 		BeginFrame();
 
 		// The PreUpdate hook should be used for setting up per-frame state, etc.
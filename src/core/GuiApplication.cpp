@@ -165,6 +165,8 @@ Graphics::Renderer *GuiApplication::StartupRenderer(IniConfig *config, bool hidd
 	const std::string rendererName = config->String("RendererName", Graphics::RendererNameFromType(Graphics::RENDERER_OPENGL_3x));
 	// if we add new renderer types, make sure to update this logic
 	Graphics::RendererType rType = Graphics::RENDERER_OPENGL_3x;
+	if (rendererName == Graphics::RendererNameFromType(Graphics::RENDERER_DUMMY))
+		rType = Graphics::RENDERER_DUMMY;
 
 	Graphics::Settings videoSettings = {};
 	videoSettings.rendererType = rType;
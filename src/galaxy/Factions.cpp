@@ -19,6 +19,7 @@
 #include "lua/LuaUtils.h"
 #include "lua/LuaVector.h"
 #include <algorithm>
+#include <cfloat>
 #include <list>
 #include <set>
 #include <sstream>
@@ -455,6 +456,8 @@ void FactionsDatabase::Init()
 	LUA_DEBUG_END(L, 0);
 	lua_close(L);
 
+	m_spatial_index.Build();
+
 	Output("Number of factions added: " SIZET_FMT "\n", m_factions.size());
 	ClearHomeSectors();
 	m_galaxy->FlushCaches(); // clear caches of anything we used for faction generation
@@ -570,7 +573,8 @@ const Faction *FactionsDatabase::GetNearestClaimant(const Sector::System *sys) c
 	// if it didn't, or it wasn't a custom StarStystem, then we go ahead and assign it a faction allegiance like normal below...
 	const Faction *result = &m_no_faction;
 	double closestFactionDist = HUGE_VAL;
-	ConstFactionList &candidates = m_spatial_index.CandidateFactions(sys);
+	std::vector<const Faction *> candidates;
+	m_spatial_index.CandidateFactions(sys, candidates);
 
 	for (ConstFactionIterator it = candidates.begin(); it != candidates.end(); ++it) {
 		if ((*it)->IsClaimed(sys->GetPath()))
@@ -775,95 +779,131 @@ Faction::Faction(Galaxy *galaxy) :
 
 // ------ Factions Spatial Indexing ------
 
-void FactionsDatabase::Octsapling::Add(const Faction *faction)
+// territories per leaf of the k-d tree
+static const Uint32 TERRITORY_LEAF_SIZE = 4;
+
+void FactionsDatabase::TerritoryIndex::Add(const Faction *faction)
 {
 	PROFILE_SCOPED()
-	/*  The general principle here is to put the faction in every octbox cell that a system
-	    that is a member of that faction could be in. This should let us cut the number
-		of factions that have to be checked by GetNearestFaction, by eliminating right off
-		all the those Factions that aren't in the same cell.
-
-		As I'm just going for the quick performance win, I'm being very sloppy and
-		treating a Faction as if it was a cube rather than a sphere. I'm also not even
-		attempting to work out real faction boundaries for this.
-
-		Obviously this all could be improved even without this Octsapling growing into
-		a full Octree.
-
-		This part happens at faction generation time so shouldn't be too performance
-		critical
+	/* This part happens at faction generation time, while the home sectors
+	   can still be looked up, so shouldn't be too performance critical.
 	*/
 	RefCountedPtr<const Sector> sec = faction->GetHomeSector();
 
 	/* only factions with homeworlds that are available at faction generation time can
-	   be added to specific cells...
+	   be placed in the tree. Others, such as ones with no homeworlds, and more
+	   annoyingly ones whose homeworlds don't exist yet because they're custom
+	   systems, have to be checked for every system
 	*/
 	if (faction->hasHomeworld && (faction->homeworld.systemIndex < sec->m_systems.size())) {
-		/* calculate potential indexes for the octbox cells the faction needs to go into
+		const Sector::System &sys = sec->m_systems[faction->homeworld.systemIndex];
+
+		/* anything in the homeworld's sector belongs to the faction whatever
+		   its radius, so the territory is grown to take the sector in
 		*/
-		Sector::System sys = sec->m_systems[faction->homeworld.systemIndex];
+		Territory t;
+		t.faction = faction;
+		t.centre = sys.GetFullPosition();
+		t.radius = std::max(float(faction->Radius()), 0.0f) + Sector::SIZE * 1.75f;
+		m_territories.push_back(t);
+	} else
+		m_everywhere.push_back(faction);
+}
 
-		int xmin = BoxIndex(Sint32(sys.GetFullPosition().x - float((faction->Radius()))));
-		int xmax = BoxIndex(Sint32(sys.GetFullPosition().x + float((faction->Radius()))));
-		int ymin = BoxIndex(Sint32(sys.GetFullPosition().y - float((faction->Radius()))));
-		int ymax = BoxIndex(Sint32(sys.GetFullPosition().y + float((faction->Radius()))));
-		int zmin = BoxIndex(Sint32(sys.GetFullPosition().z - float((faction->Radius()))));
-		int zmax = BoxIndex(Sint32(sys.GetFullPosition().z + float((faction->Radius()))));
+void FactionsDatabase::TerritoryIndex::Build()
+{
+	PROFILE_SCOPED()
+	/* claims on systems and sectors are answered before any distances, and
+	   may be outside the faction's territory
+	*/
+	auto claimant = std::stable_partition(m_territories.begin(), m_territories.end(),
+		[](const Territory &t) { return t.faction->m_ownedsystemlist.empty(); });
+	for (auto it = claimant; it != m_territories.end(); ++it)
+		m_everywhere.push_back(it->faction);
+	m_territories.erase(claimant, m_territories.end());
 
-		/* put the faction in all the octbox cells needed in a hideously inexact way that
-		   will generate duplicates in each cell in many cases
-		*/
-		octbox[xmin][ymin][zmin].push_back(faction); // 0,0,0
-		octbox[xmax][ymin][zmin].push_back(faction); // 1,0,0
-		octbox[xmax][ymax][zmin].push_back(faction); // 1,1,0
-		octbox[xmax][ymax][zmax].push_back(faction); // 1,1,1
+	std::sort(m_everywhere.begin(), m_everywhere.end(),
+		[](const Faction *a, const Faction *b) { return a->idx < b->idx; });
 
-		octbox[xmin][ymax][zmin].push_back(faction); // 0,1,0
-		octbox[xmin][ymax][zmax].push_back(faction); // 0,1,1
-		octbox[xmin][ymin][zmax].push_back(faction); // 0,0,1
-		octbox[xmax][ymin][zmax].push_back(faction); // 1,0,1
+	m_nodes.clear();
+	if (!m_territories.empty())
+		BuildNode(0, m_territories.size());
+}
 
-		/* prune any duplicates from the octbox cells making things slightly saner
-		*/
-		PruneDuplicates(0, 0, 0);
-		PruneDuplicates(1, 0, 0);
-		PruneDuplicates(1, 1, 0);
-		PruneDuplicates(1, 1, 1);
+Sint32 FactionsDatabase::TerritoryIndex::BuildNode(Uint32 begin, Uint32 end)
+{
+	const Sint32 index = m_nodes.size();
+	m_nodes.emplace_back();
 
-		PruneDuplicates(0, 1, 0);
-		PruneDuplicates(0, 1, 1);
-		PruneDuplicates(0, 0, 1);
-		PruneDuplicates(1, 0, 1);
+	vector3f min(FLT_MAX), max(-FLT_MAX);
+	for (Uint32 i = begin; i < end; i++) {
+		const Territory &t = m_territories[i];
+		const vector3f r(t.radius);
+		min = vector3f(std::min(min.x, t.centre.x - r.x), std::min(min.y, t.centre.y - r.y), std::min(min.z, t.centre.z - r.z));
+		max = vector3f(std::max(max.x, t.centre.x + r.x), std::max(max.y, t.centre.y + r.y), std::max(max.z, t.centre.z + r.z));
+	}
 
-	} else {
-		/* ...other factions, such as ones with no homeworlds, and more annoyingly ones
-	   whose homeworlds don't exist yet because they're custom systems have to go in
-	   *every* octbox cell
-	*/
-		octbox[0][0][0].push_back(faction);
-		octbox[1][0][0].push_back(faction);
-		octbox[1][1][0].push_back(faction);
-		octbox[1][1][1].push_back(faction);
-
-		octbox[0][1][0].push_back(faction);
-		octbox[0][1][1].push_back(faction);
-		octbox[0][0][1].push_back(faction);
-		octbox[1][0][1].push_back(faction);
+	Sint32 left = -1, right = -1;
+	if (end - begin > TERRITORY_LEAF_SIZE) {
+		// split the homeworlds at the median of the longest axis
+		const vector3f size = max - min;
+		const int axis = (size.x > size.y && size.x > size.z) ? 0 : (size.y > size.z ? 1 : 2);
+		const Uint32 mid = (begin + end) / 2;
+		std::nth_element(m_territories.begin() + begin, m_territories.begin() + mid, m_territories.begin() + end,
+			[axis](const Territory &a, const Territory &b) { return a.centre[axis] < b.centre[axis]; });
+		left = BuildNode(begin, mid);
+		right = BuildNode(mid, end);
 	}
-}
 
-void FactionsDatabase::Octsapling::PruneDuplicates(const int bx, const int by, const int bz)
-{
-	PROFILE_SCOPED()
-	octbox[bx][by][bz].erase(std::unique(octbox[bx][by][bz].begin(), octbox[bx][by][bz].end()), octbox[bx][by][bz].end());
+	Node &node = m_nodes[index];
+	node.min = min;
+	node.max = max;
+	node.begin = begin;
+	node.end = end;
+	node.left = left;
+	node.right = right;
+	return index;
 }
 
-const std::vector<const Faction *> &FactionsDatabase::Octsapling::CandidateFactions(const Sector::System *sys) const
+void FactionsDatabase::TerritoryIndex::CandidateFactions(const Sector::System *sys, std::vector<const Faction *> &candidates) const
 {
 	PROFILE_SCOPED()
-	/* answer the factions that we've put in the same octobox cell as the one the
-	   system would go in. This part happens every time we do GetNearest faction
-	   so *is* performance criticale.e
+	/* answer the factions whose territory might contain the system. This part
+	   happens every time we do GetNearestClaimant so *is* performance critical.
 	*/
-	return octbox[BoxIndex(sys->sx)][BoxIndex(sys->sy)][BoxIndex(sys->sz)];
+	candidates.assign(m_everywhere.begin(), m_everywhere.end());
+	if (m_nodes.empty())
+		return;
+
+	const vector3f p = sys->GetFullPosition();
+	const size_t numEverywhere = candidates.size();
+
+	Sint32 stack[64];
+	int depth = 0;
+	stack[depth++] = 0;
+	while (depth) {
+		const Node &node = m_nodes[stack[--depth]];
+		if (p.x < node.min.x || p.y < node.min.y || p.z < node.min.z ||
+			p.x > node.max.x || p.y > node.max.y || p.z > node.max.z)
+			continue;
+
+		if (node.left < 0) {
+			for (Uint32 i = node.begin; i < node.end; i++) {
+				const Territory &t = m_territories[i];
+				if ((p - t.centre).LengthSqr() <= t.radius * t.radius)
+					candidates.push_back(t.faction);
+			}
+		} else {
+			stack[depth++] = node.left;
+			stack[depth++] = node.right;
+		}
+	}
+
+	// back into the order the factions were added, which decides between
+	// claims and between factions at the same distance
+	if (candidates.size() > numEverywhere) {
+		auto byIndex = [](const Faction *a, const Faction *b) { return a->idx < b->idx; };
+		std::sort(candidates.begin() + numEverywhere, candidates.end(), byIndex);
+		std::inplace_merge(candidates.begin(), candidates.begin() + numEverywhere, candidates.end(), byIndex);
+	}
 }
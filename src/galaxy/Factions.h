@@ -79,11 +79,6 @@ private:
 	bool IsCloserAndContains(double &closestFactionDist, const Sector::System *sys) const;
 };
 
-/* One day it might grow up to become a full tree, on the  other hand it might be
-   cut down before it's full growth to be replaced by
-   a proper spatial data structure.
-*/
-
 class FactionsDatabase {
 public:
 	FactionsDatabase(Galaxy *galaxy, const std::string &factionDir) :
@@ -112,15 +107,37 @@ public:
 	bool MayAssignFactions() const;
 
 private:
-	class Octsapling {
+	/* Answers which factions' territories may contain a system. Territories
+	   are spheres around the homeworlds, kept in a k-d tree of their bounding
+	   boxes; factions that can be anywhere (no homeworld yet, or claims on
+	   particular systems) are returned for every system.
+	*/
+	class TerritoryIndex {
 	public:
 		void Add(const Faction *faction);
-		const std::vector<const Faction *> &CandidateFactions(const Sector::System *sys) const;
+		// must be called once all factions are added, before any lookups
+		void Build();
+		// candidates are left in the order the factions were added
+		void CandidateFactions(const Sector::System *sys, std::vector<const Faction *> &candidates) const;
 
 	private:
-		std::vector<const Faction *> octbox[2][2][2];
-		static int BoxIndex(Sint32 sectorIndex) { return sectorIndex < 0 ? 0 : 1; };
-		void PruneDuplicates(const int bx, const int by, const int bz);
+		struct Territory {
+			const Faction *faction;
+			vector3f centre;
+			float radius;
+		};
+
+		struct Node {
+			vector3f min, max; // bounds of the territories below
+			Uint32 begin, end; // territories, for leaves
+			Sint32 left, right; // child nodes, -1 for leaves
+		};
+
+		Sint32 BuildNode(Uint32 begin, Uint32 end);
+
+		std::vector<Territory> m_territories;
+		std::vector<Node> m_nodes;
+		std::vector<const Faction *> m_everywhere;
 	};
 
 	typedef std::vector<Faction *> FactionList;
@@ -140,7 +157,7 @@ private:
 	FactionList m_factions;
 	FactionMap m_factions_byName;
 	HomeSystemSet m_homesystems;
-	Octsapling m_spatial_index;
+	TerritoryIndex m_spatial_index;
 	bool m_may_assign_factions;
 	bool m_initialized = false;
 	MissingFactionsMap m_missingFactionsMap;
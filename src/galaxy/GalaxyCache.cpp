@@ -9,11 +9,18 @@
 #include "galaxy/Sector.h"
 #include "galaxy/StarSystem.h"
 #include "Pi.h"
+#include "profiler/Profiler.h"
 #include "utils.h"
+#include <algorithm>
 #include <utility>
 
 //#define DEBUG_CACHE
 
+// how long a cache job should run for, in milliseconds. jobs on the sync
+// queue run one per frame on the main thread, so this is also the most a
+// cache fill should add to a frame
+static const double CACHE_JOB_TIME = 8.0;
+
 //virtual
 
 template <typename T, typename CompareT>
@@ -88,10 +95,37 @@ void GalaxyObjectCache<T, CompareT>::ClearCache()
 		(*it)->ClearCache();
 }
 
+template <typename T, typename CompareT>
+unsigned GalaxyObjectCache<T, CompareT>::GetJobSize(size_t count, const JobQueue *jobQueue) const
+{
+	// enough to keep a job busy for about CACHE_JOB_TIME
+	unsigned size = CACHE_JOB_SIZE;
+	if (m_itemCost > 0.0)
+		size = unsigned(Clamp(CACHE_JOB_TIME / m_itemCost, 1.0, double(MAX_CACHE_JOB_SIZE)));
+
+	// but no bigger than it takes to give every runner a share
+	const unsigned runners = jobQueue->GetNumRunners();
+	if (runners > 1)
+		size = std::min(size, unsigned((count + runners - 1) / runners));
+
+	return std::max(size, 1u);
+}
+
+template <typename T, typename CompareT>
+void GalaxyObjectCache<T, CompareT>::UpdateItemCost(size_t count, double milliseconds)
+{
+	if (!count)
+		return;
+
+	// a moving average, generation cost varies a lot between objects
+	const double cost = milliseconds / count;
+	m_itemCost = m_itemCost > 0.0 ? 0.8 * m_itemCost + 0.2 * cost : cost;
+}
+
 template <typename T, typename CompareT>
 void GalaxyObjectCache<T, CompareT>::OutputCacheStatistics(bool reset)
 {
-	Output("%s: misses: %llu, slave hits: %llu, master hits: %llu\n", CACHE_NAME.c_str(), m_cacheMisses, m_cacheHitsSlave, m_cacheHits);
+	Output("%s: misses: %llu, slave hits: %llu, master hits: %llu, %.3fms per object\n", CACHE_NAME.c_str(), m_cacheMisses, m_cacheHitsSlave, m_cacheHits, m_itemCost);
 	if (reset)
 		m_cacheMisses = m_cacheHitsSlave = m_cacheHits = 0;
 }
@@ -186,17 +220,12 @@ template <typename T, typename CompareT>
 void GalaxyObjectCache<T, CompareT>::Slave::FillCache(const typename GalaxyObjectCache<T, CompareT>::PathVector &paths,
 	typename GalaxyObjectCache<T, CompareT>::CacheFilledCallback callback)
 {
-	// allocate some space for what we're about to chunk up
-	std::vector<std::unique_ptr<PathVector>> vec_paths;
-	vec_paths.reserve(paths.size() / CACHE_JOB_SIZE + 1);
-	std::unique_ptr<PathVector> current_paths;
+	PathVector missing;
 #ifdef DEBUG_CACHE
 	size_t alreadyCached = m_cache.size();
 	unsigned masterCached = 0;
-	unsigned toBeCreated = 0;
 #endif
 
-	// chop the paths into groups of CACHE_JOB_SIZE
 	for (auto it = paths.begin(), itEnd = paths.end(); it != itEnd; ++it) {
 		RefCountedPtr<T> s = m_master->GetIfCached(*it);
 		if (s) {
@@ -204,29 +233,22 @@ void GalaxyObjectCache<T, CompareT>::Slave::FillCache(const typename GalaxyObjec
 #ifdef DEBUG_CACHE
 			++masterCached;
 #endif
-		} else {
-			if (!current_paths) {
-				current_paths.reset(new PathVector);
-				current_paths->reserve(CACHE_JOB_SIZE);
-			}
-			current_paths->push_back(*it);
-			if (current_paths->size() >= CACHE_JOB_SIZE) {
-				vec_paths.push_back(std::move(current_paths));
-			}
-#ifdef DEBUG_CACHE
-			++toBeCreated;
-#endif
-		}
+		} else
+			missing.push_back(*it);
 	}
 
-	// catch the last loop in case it's got some entries (could be less than the spread width)
-	if (current_paths) {
-		vec_paths.push_back(std::move(current_paths));
+	// chop the paths into groups sized by how long they've been taking
+	const unsigned jobSize = m_master->GetJobSize(missing.size(), m_jobs.GetQueue());
+	std::vector<std::unique_ptr<PathVector>> vec_paths;
+	vec_paths.reserve(missing.size() / jobSize + 1);
+	for (size_t i = 0; i < missing.size(); i += jobSize) {
+		const size_t end = std::min(i + jobSize, missing.size());
+		vec_paths.emplace_back(new PathVector(missing.begin() + i, missing.begin() + end));
 	}
 
 #ifdef DEBUG_CACHE
-	Output("%s: FillCache: " SIZET_FMT " cached, %u in master cache, %u to be created, will use " SIZET_FMT " jobs\n", CACHE_NAME.c_str(),
-		alreadyCached, masterCached, toBeCreated, vec_paths.size());
+	Output("%s: FillCache: " SIZET_FMT " cached, %u in master cache, " SIZET_FMT " to be created, will use " SIZET_FMT " jobs of %u\n", CACHE_NAME.c_str(),
+		alreadyCached, masterCached, missing.size(), vec_paths.size(), jobSize);
 #endif
 
 	if (vec_paths.empty()) {
@@ -248,7 +270,8 @@ GalaxyObjectCache<T, CompareT>::CacheJob::CacheJob(std::unique_ptr<std::vector<S
 	m_slaveCache(slaveCache),
 	m_galaxy(galaxy),
 	m_galaxyGenerator(galaxy->GetGenerator()),
-	m_callback(callback)
+	m_callback(callback),
+	m_runTime(0.0)
 {
 	m_objects.reserve(m_paths->size());
 }
@@ -257,14 +280,21 @@ GalaxyObjectCache<T, CompareT>::CacheJob::CacheJob(std::unique_ptr<std::vector<S
 template <typename T, typename CompareT>
 void GalaxyObjectCache<T, CompareT>::CacheJob::OnRun() // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
 {
+	PROFILE_SCOPED()
+	Profiler::Clock timer;
+	timer.Start();
 	for (auto it = m_paths->begin(), itEnd = m_paths->end(); it != itEnd; ++it)
 		m_objects.push_back(m_galaxyGenerator->Generate<T, GalaxyObjectCache<T, CompareT>>(m_galaxy, *it, nullptr));
+	timer.Stop();
+	m_runTime = timer.milliseconds();
 }
 
 //virtual
 template <typename T, typename CompareT>
 void GalaxyObjectCache<T, CompareT>::CacheJob::OnFinish() // runs in primary thread of the context
 {
+	if (m_slaveCache->m_master)
+		m_slaveCache->m_master->UpdateItemCost(m_paths->size(), m_runTime);
 	m_slaveCache->AddToCache(m_objects);
 	if (m_slaveCache->m_jobs.IsEmpty() && m_callback)
 		m_callback();
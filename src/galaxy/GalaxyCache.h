@@ -27,7 +27,8 @@ public:
 		m_galaxy(galaxy),
 		m_cacheHits(0),
 		m_cacheHitsSlave(0),
-		m_cacheMisses(0) {}
+		m_cacheMisses(0),
+		m_itemCost(0.0) {}
 	~GalaxyObjectCache();
 
 	RefCountedPtr<T> GetCached(const SystemPath &path);
@@ -73,7 +74,13 @@ public:
 	RefCountedPtr<Slave> NewSlaveCache();
 
 private:
+	// objects per job until the cost of generating one is known
 	static const unsigned CACHE_JOB_SIZE = 100;
+	static const unsigned MAX_CACHE_JOB_SIZE = 1000;
+
+	// how many objects to generate per job, when count of them are wanted
+	unsigned GetJobSize(size_t count, const JobQueue *jobQueue) const;
+	void UpdateItemCost(size_t count, double milliseconds);
 
 	void AddToCache(std::vector<RefCountedPtr<T>> &objects);
 	bool HasCached(const SystemPath &path) const;
@@ -97,6 +104,7 @@ private:
 		RefCountedPtr<Galaxy> m_galaxy;
 		RefCountedPtr<GalaxyGenerator> m_galaxyGenerator;
 		CacheFilledCallback m_callback;
+		double m_runTime; // milliseconds
 	};
 
 	Galaxy *m_galaxy;
@@ -108,6 +116,8 @@ private:
 	unsigned long long m_cacheHits;
 	unsigned long long m_cacheHitsSlave;
 	unsigned long long m_cacheMisses;
+
+	double m_itemCost; // average milliseconds to generate an object, 0 until measured
 };
 
 class Sector;
@@ -153,6 +153,14 @@ GalaxyGenerator::~GalaxyGenerator()
 		delete sysgen;
 }
 
+bool GalaxyGenerator::SectorMayHaveSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const
+{
+	for (const SectorGeneratorStage *secgen : m_sectorStage)
+		if (secgen->MayAddSystems(galaxy, sx, sy, sz))
+			return true;
+	return false;
+}
+
 GalaxyGenerator *GalaxyGenerator::AddSectorStage(SectorGeneratorStage *sectorGenerator)
 {
 	auto it = m_sectorStage.insert(m_sectorStage.end(), sectorGenerator);
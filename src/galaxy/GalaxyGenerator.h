@@ -47,6 +47,9 @@ public:
 	template <typename T, typename Cache>
 	RefCountedPtr<T> Generate(RefCountedPtr<Galaxy> galaxy, const SystemPath &path, Cache *cache);
 
+	// false if the sector is sure to be empty, without generating it
+	bool SectorMayHaveSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const;
+
 	GalaxyGenerator *AddSectorStage(SectorGeneratorStage *sectorGenerator);
 	GalaxyGenerator *AddStarSystemStage(StarSystemGeneratorStage *starSystemGenerator);
 
@@ -117,6 +120,10 @@ public:
 	virtual ~SectorGeneratorStage() {}
 
 	virtual bool Apply(Random &rng, RefCountedPtr<Galaxy> galaxy, RefCountedPtr<Sector> sector, GalaxyGenerator::SectorConfig *config) = 0;
+
+	// false if the stage can't add any systems to the sector, answered
+	// without generating it
+	virtual bool MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const { return true; }
 };
 
 class StarSystemGeneratorStage : public GalaxyGeneratorStage {
@@ -13,6 +13,10 @@
 
 #define Square(x) ((x) * (x))
 
+// random systems in a sector of full (255) density
+static const int MIN_RANDOM_SYSTEMS = 4;
+static const int MAX_RANDOM_SYSTEMS = 20;
+
 static const unsigned int SYS_NAME_FRAGS = 32;
 static const char *sys_names[SYS_NAME_FRAGS] = { "en", "la", "can", "be", "and", "phi", "eth", "ol", "ve", "ho", "a",
 	"lia", "an", "ar", "ur", "mi", "in", "ti", "qu", "so", "ed", "ess",
@@ -67,6 +71,18 @@ bool SectorCustomSystemsGenerator::Apply(Random &rng, RefCountedPtr<Galaxy> gala
 	return true;
 }
 
+bool SectorCustomSystemsGenerator::MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const
+{
+	return !galaxy->GetCustomSystems()->GetCustomSystemsForSector(sx, sy, sz).empty();
+}
+
+bool SectorRandomSystemsGenerator::MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const
+{
+	// as Apply rounds it, sparse sectors get no systems at all. custom-only
+	// sectors are ignored, this only has to be right when it says no
+	return ((MAX_RANDOM_SYSTEMS * galaxy->GetSectorDensity(sx, sy, sz)) >> 8) > 0;
+}
+
 const std::string SectorRandomSystemsGenerator::GenName(RefCountedPtr<Galaxy> galaxy, const Sector &sec, Sector::System &sys, int si, Random &rng)
 {
 	std::string name;
@@ -144,7 +160,7 @@ bool SectorRandomSystemsGenerator::Apply(Random &rng, RefCountedPtr<Galaxy> gala
 	const Sint64 dist = (1 + sx * sx + sy * sy + sz * sz);
 	const Sint64 freq = (1 + sx * sx + sy * sy);
 
-	const int numSystems = (rng.Int32(4, 20) * galaxy->GetSectorDensity(sx, sy, sz)) >> 8;
+	const int numSystems = (rng.Int32(MIN_RANDOM_SYSTEMS, MAX_RANDOM_SYSTEMS) * galaxy->GetSectorDensity(sx, sy, sz)) >> 8;
 	sector->m_systems.reserve(numSystems);
 
 	for (int i = 0; i < numSystems; i++) {
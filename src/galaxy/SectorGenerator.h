@@ -15,6 +15,7 @@ public:
 	SectorCustomSystemsGenerator(int customOnlyRadius) :
 		m_customOnlyRadius(customOnlyRadius) {}
 	virtual bool Apply(Random &rng, RefCountedPtr<Galaxy> galaxy, RefCountedPtr<Sector> sector, GalaxyGenerator::SectorConfig *config);
+	virtual bool MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const;
 
 private:
 	int m_customOnlyRadius;
@@ -23,6 +24,7 @@ private:
 class SectorRandomSystemsGenerator : public SectorGeneratorStage {
 public:
 	virtual bool Apply(Random &rng, RefCountedPtr<Galaxy> galaxy, RefCountedPtr<Sector> sector, GalaxyGenerator::SectorConfig *config);
+	virtual bool MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const;
 
 private:
 	const std::string GenName(RefCountedPtr<Galaxy> galaxy, const Sector &sec, Sector::System &sys, int si, Random &rand);
@@ -33,6 +35,7 @@ public:
 	SectorPersistenceGenerator(GalaxyGenerator::Version version) :
 		m_version(version) {}
 	virtual bool Apply(Random &rng, RefCountedPtr<Galaxy> galaxy, RefCountedPtr<Sector> sector, GalaxyGenerator::SectorConfig *config);
+	virtual bool MayAddSystems(RefCountedPtr<Galaxy> galaxy, int sx, int sy, int sz) const { return false; }
 	virtual void FromJson(const Json &jsonObj, RefCountedPtr<Galaxy> galaxy);
 	virtual void ToJson(Json &jsonObj, RefCountedPtr<Galaxy> galaxy);
 
@@ -422,7 +422,8 @@ void StarSystemCustomGenerator::CustomGetKidsOf(RefCountedPtr<StarSystem::Genera
 		kid->m_volcanicity = csbody->volcanicity;
 		kid->m_atmosOxidizing = csbody->atmosOxidizing;
 		kid->m_life = csbody->life;
-		kid->m_space_station_type = csbody->spaceStationType;
+		if (!csbody->spaceStationType.empty())
+			kid->GetOrCreateCustomData().spaceStationType = csbody->spaceStationType;
 		kid->m_rotationPeriod = csbody->rotationPeriod;
 		kid->m_rotationalPhaseAtStart = csbody->rotationalPhaseAtStart;
 		kid->m_eccentricity = csbody->eccentricity;
@@ -435,8 +436,9 @@ void StarSystemCustomGenerator::CustomGetKidsOf(RefCountedPtr<StarSystem::Genera
 		kid->m_semiMajorAxis = csbody->semiMajorAxis;
 
 		if (csbody->heightMapFilename.length() > 0) {
-			kid->m_heightMapFilename = csbody->heightMapFilename;
-			kid->m_heightMapFractal = csbody->heightMapFractal;
+			SystemBody::CustomData &custom = kid->GetOrCreateCustomData();
+			custom.heightMapFilename = csbody->heightMapFilename;
+			custom.heightMapFractal = csbody->heightMapFractal;
 		}
 
 		if (parent->GetType() == SystemBody::TYPE_GRAVPOINT) // generalize Kepler's law to multiple stars
@@ -8,6 +8,77 @@
 #include "AtmosphereParameters.h"
 #include "enum_table.h"
 #include "utils.h"
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+/* Cached star systems hold hundreds of bodies between them, and generating
+   a system creates and throws away a few dozen. Rather than one heap
+   allocation per body, they are carved out of larger blocks and freed bodies
+   are reused by the next system generated. The free list is LIFO, so once
+   bodies have been recycled a system's bodies are not laid out in any
+   particular order. The blocks are kept until exit, sized by the largest
+   number of bodies alive at once.
+*/
+namespace {
+	const size_t BODIES_PER_BLOCK = 256;
+
+	struct FreeBody {
+		FreeBody *next;
+	};
+
+	// malloc's alignment is good for anything, every body is kept at it
+	const size_t BODY_ALIGN = alignof(std::max_align_t);
+	const size_t BODY_SIZE = (sizeof(SystemBody) + BODY_ALIGN - 1) / BODY_ALIGN * BODY_ALIGN;
+
+	// systems can be generated from job threads
+	std::mutex s_poolLock;
+	FreeBody *s_freeBodies = nullptr;
+
+	void AllocateBodyBlock()
+	{
+		char *block = static_cast<char *>(std::malloc(BODY_SIZE * BODIES_PER_BLOCK));
+		if (!block)
+			throw std::bad_alloc();
+
+		for (size_t i = BODIES_PER_BLOCK; i-- > 0;) {
+			FreeBody *body = reinterpret_cast<FreeBody *>(block + i * BODY_SIZE);
+			body->next = s_freeBodies;
+			s_freeBodies = body;
+		}
+	}
+} // namespace
+
+void *SystemBody::operator new(size_t size)
+{
+	// nothing derives from SystemBody, but just in case
+	if (size != sizeof(SystemBody))
+		return ::operator new(size);
+
+	std::lock_guard<std::mutex> lock(s_poolLock);
+	if (!s_freeBodies)
+		AllocateBodyBlock();
+
+	FreeBody *body = s_freeBodies;
+	s_freeBodies = body->next;
+	return body;
+}
+
+void SystemBody::operator delete(void *p, size_t size)
+{
+	if (!p)
+		return;
+	if (size != sizeof(SystemBody)) {
+		::operator delete(p);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_poolLock);
+	FreeBody *body = static_cast<FreeBody *>(p);
+	body->next = s_freeBodies;
+	s_freeBodies = body;
+}
 
 SystemBody::SystemBody(const SystemPath &path, StarSystem *system) :
 	m_parent(nullptr),
@@ -25,12 +96,30 @@ SystemBody::SystemBody(const SystemPath &path, StarSystem *system) :
 	m_averageTemp(0),
 	m_type(TYPE_GRAVPOINT),
 	m_isCustomBody(false),
-	m_heightMapFractal(0),
 	m_atmosDensity(0.0),
 	m_system(system)
 {
 }
 
+const std::string &SystemBody::GetHeightMapFilename() const
+{
+	static const std::string empty;
+	return m_customData ? m_customData->heightMapFilename : empty;
+}
+
+const std::string &SystemBody::GetSpaceStationType() const
+{
+	static const std::string empty;
+	return m_customData ? m_customData->spaceStationType : empty;
+}
+
+SystemBody::CustomData &SystemBody::GetOrCreateCustomData()
+{
+	if (!m_customData)
+		m_customData.reset(new CustomData);
+	return *m_customData;
+}
+
 bool SystemBody::HasAtmosphere() const
 {
 	PROFILE_SCOPED()
@@ -554,8 +643,8 @@ void SystemBody::Dump(FILE *file, const char *indent) const
 			m_rings.maxRadius.ToDouble() * 100.0, m_rings.baseColor.r, m_rings.baseColor.g, m_rings.baseColor.b, m_rings.baseColor.a);
 		fprintf(file, "%s\thuman activity %.2f, population %.0f, agricultural %.2f\n", indent, m_humanActivity.ToDouble() * 100.0,
 			m_population.ToDouble() * 1e9, m_agricultural.ToDouble() * 100.0);
-		if (!m_heightMapFilename.empty()) {
-			fprintf(file, "%s\theightmap \"%s\", fractal %u\n", indent, m_heightMapFilename.c_str(), m_heightMapFractal);
+		if (!GetHeightMapFilename().empty()) {
+			fprintf(file, "%s\theightmap \"%s\", fractal %u\n", indent, GetHeightMapFilename().c_str(), GetHeightMapFractal());
 		}
 	}
 	for (const SystemBody *kid : m_children) {
@@ -11,6 +11,7 @@
 #include "galaxy/RingStyle.h"
 #include "galaxy/SystemPath.h"
 #include "gameconsts.h"
+#include <memory>
 
 class StarSystem;
 
@@ -20,6 +21,10 @@ class SystemBody : public RefCounted {
 public:
 	SystemBody(const SystemPath &path, StarSystem *system);
 
+	// bodies are allocated from a shared pool, see SystemBody.cpp
+	static void *operator new(size_t size);
+	static void operator delete(void *p, size_t size);
+
 	enum BodyType { // <enum scope='SystemBody' prefix=TYPE_ public>
 		TYPE_GRAVPOINT = 0,
 		TYPE_BROWN_DWARF = 1, //  L+T Class Brown Dwarfs
@@ -163,8 +168,8 @@ public:
 	void SetOrbitPlane(const matrix3x3d &orient) { m_orbit.SetPlane(orient); }
 
 	int GetAverageTemp() const { return m_averageTemp; }
-	inline const std::string &GetHeightMapFilename() const { return m_heightMapFilename; }
-	unsigned int GetHeightMapFractal() const { return m_heightMapFractal; }
+	const std::string &GetHeightMapFilename() const;
+	unsigned int GetHeightMapFractal() const { return m_customData ? m_customData->heightMapFractal : 0; }
 
 	Uint32 GetSeed() const { return m_seed; }
 
@@ -218,7 +223,7 @@ public:
 
 	StarSystem *GetStarSystem() const { return m_system; }
 
-	const std::string &GetSpaceStationType() const { return m_space_station_type; }
+	const std::string &GetSpaceStationType() const;
 
 private:
 	friend class StarSystem;
@@ -230,6 +235,18 @@ private:
 
 	void ClearParentAndChildPointers();
 
+	// only bodies from custom systems set these, so they are kept out of
+	// line rather than making every generated body carry the strings
+	struct CustomData {
+		CustomData() :
+			heightMapFractal(0) {}
+
+		std::string heightMapFilename;
+		unsigned int heightMapFractal;
+		std::string spaceStationType;
+	};
+	CustomData &GetOrCreateCustomData();
+
 	SystemBody *m_parent;				  // these are only valid if the StarSystem
 	std::vector<SystemBody *> m_children; // that create them still exists
 
@@ -269,15 +286,12 @@ private:
 	fixed m_population;
 	fixed m_agricultural;
 
-	std::string m_heightMapFilename;
-	unsigned int m_heightMapFractal;
-
 	Color m_atmosColor;
 	double m_atmosDensity;
 
 	StarSystem *m_system;
 
-	std::string m_space_station_type;
+	std::unique_ptr<CustomData> m_customData;
 };
 
 #endif // SYSTEMBODY_H
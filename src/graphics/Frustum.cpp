@@ -102,6 +102,20 @@ namespace Graphics {
 		return true;
 	}
 
+	void Frustum::TestPointsInfinite(size_t count, const double *x, const double *y, const double *z, const double *radius, Uint8 *visible) const
+	{
+		PROFILE_SCOPED()
+		for (size_t j = 0; j < count; j++)
+			visible[j] = 1;
+
+		// plane by plane, so the inner loop is a straight run over the arrays
+		for (int i = 0; i < 5; i++) {
+			const SPlane &p = m_planes[i];
+			for (size_t j = 0; j < count; j++)
+				visible[j] &= Uint8(!(p.a * x[j] + p.b * y[j] + p.c * z[j] + p.d + radius[j] < 0));
+		}
+	}
+
 	bool Frustum::ProjectPoint(const vector3d &in, vector3d &out) const
 	{
 		// see the OpenGL documentation
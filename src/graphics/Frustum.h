@@ -24,6 +24,9 @@ namespace Graphics {
 		bool TestPoint(const vector3d &p, double radius) const;
 		// test if point (sphere) is in the frustum, ignoring the far plane
 		bool TestPointInfinite(const vector3d &p, double radius) const;
+		// TestPointInfinite for count spheres at once, given as separate arrays
+		// of coordinates and radii. visible[i] is set to 0 or 1
+		void TestPointsInfinite(size_t count, const double *x, const double *y, const double *z, const double *radius, Uint8 *visible) const;
 
 		// project a point onto the near plane (typically the screen)
 		bool ProjectPoint(const vector3d &in, vector3d &out) const;
@@ -100,6 +100,8 @@ namespace Graphics {
 		virtual void Apply() {}
 		virtual void Unapply() {}
 		virtual bool IsProgramLoaded() const = 0;
+		// identifies the shader behind the material, so draws sharing it can be grouped
+		virtual Uint32 GetProgramID() const { return 0; }
 
 		virtual void SetCommonUniforms(const matrix4x4f &mv, const matrix4x4f &proj) = 0;
 
@@ -0,0 +1,109 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "RenderQueue.h"
+#include "Material.h"
+#include "RenderState.h"
+#include "Renderer.h"
+#include "profiler/Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Graphics {
+
+	// only used to bring equal pointers together, collisions just cost a state change
+	static inline Uint64 PointerBits(const void *p, unsigned int bits)
+	{
+		return (Uint64(reinterpret_cast<uintptr_t>(p)) >> 4) & ((Uint64(1) << bits) - 1);
+	}
+
+	// the bits of a non-negative float sort in the same order as its value
+	static inline Uint32 DepthBits(const matrix4x4f &trans)
+	{
+		const float depth = std::max(-trans[14], 0.0f);
+		Uint32 bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		return bits;
+	}
+
+	RenderQueue::RenderQueue(Renderer *r) :
+		m_renderer(r),
+		m_enabled(true),
+		m_depth(0)
+	{
+	}
+
+	void RenderQueue::Begin()
+	{
+		++m_depth;
+	}
+
+	void RenderQueue::End()
+	{
+		assert(m_depth > 0);
+		if (--m_depth == 0)
+			Flush();
+	}
+
+	void RenderQueue::DrawBuffer(const matrix4x4f &trans, VertexBuffer *vb, RenderState *rs, Material *mat, PrimitiveType pt)
+	{
+		Add(trans, vb, nullptr, rs, mat, pt);
+	}
+
+	void RenderQueue::DrawBufferIndexed(const matrix4x4f &trans, VertexBuffer *vb, IndexBuffer *ib, RenderState *rs, Material *mat, PrimitiveType pt)
+	{
+		Add(trans, vb, ib, rs, mat, pt);
+	}
+
+	void RenderQueue::Add(const matrix4x4f &trans, VertexBuffer *vb, IndexBuffer *ib, RenderState *rs, Material *mat, PrimitiveType pt)
+	{
+		Item item = { trans, vb, ib, rs, mat, pt };
+		if (!m_enabled || m_depth == 0) {
+			Submit(item);
+			return;
+		}
+
+		const Uint32 depth = DepthBits(trans);
+
+		Uint64 key;
+		if (rs->GetDesc().blendMode == BLEND_SOLID) {
+			// state first, then front to back to help early depth rejection
+			const Uint64 program = mat->GetProgramID() & 0xffff;
+			key = (program << 47) | (PointerBits(mat, 16) << 31) | (PointerBits(rs, 11) << 20) | (depth >> 11);
+		} else {
+			// strictly back to front, blending order matters more than state changes
+			key = (Uint64(1) << 63) | (Uint64(0x7fffffff - depth) << 32);
+		}
+
+		m_keys.push_back(std::make_pair(key, Uint32(m_items.size())));
+		m_items.push_back(item);
+	}
+
+	void RenderQueue::Submit(const Item &item)
+	{
+		m_renderer->SetTransform(item.trans);
+		if (item.ib)
+			m_renderer->DrawBufferIndexed(item.vb, item.ib, item.rs, item.mat, item.pt);
+		else
+			m_renderer->DrawBuffer(item.vb, item.rs, item.mat, item.pt);
+	}
+
+	void RenderQueue::Flush()
+	{
+		PROFILE_SCOPED()
+		if (m_items.empty())
+			return;
+
+		// the index breaks ties, keeping submission order for identical keys
+		std::sort(m_keys.begin(), m_keys.end());
+
+		Renderer::MatrixTicket ticket(m_renderer);
+		for (const auto &key : m_keys)
+			Submit(m_items[key.second]);
+
+		m_items.clear();
+		m_keys.clear();
+	}
+
+} // namespace Graphics
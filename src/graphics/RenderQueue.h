@@ -0,0 +1,68 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _GRAPHICS_RENDERQUEUE_H
+#define _GRAPHICS_RENDERQUEUE_H
+
+#include "Types.h"
+#include "matrix4x4.h"
+#include <vector>
+
+namespace Graphics {
+
+	class Renderer;
+	class RenderState;
+	class Material;
+	class VertexBuffer;
+	class IndexBuffer;
+
+	/*
+	 * Collects draw calls between Begin and End and submits them sorted,
+	 * so that draws sharing a program, material and render state follow
+	 * each other. Opaque draws go first, grouped by state and then roughly
+	 * front to back, then translucent draws strictly back to front.
+	 *
+	 * Begin/End pairs may nest, only the outermost End submits. Outside of
+	 * a Begin/End pair, or while the queue is disabled, draws are
+	 * submitted immediately.
+	 *
+	 * The queue does not hold references: buffers, materials and render
+	 * states must stay alive, and materials unchanged, until End.
+	 */
+	class RenderQueue {
+	public:
+		RenderQueue(Renderer *r);
+
+		void Begin();
+		void End();
+
+		bool IsEnabled() const { return m_enabled; }
+		void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+		void DrawBuffer(const matrix4x4f &trans, VertexBuffer *vb, RenderState *rs, Material *mat, PrimitiveType pt = TRIANGLES);
+		void DrawBufferIndexed(const matrix4x4f &trans, VertexBuffer *vb, IndexBuffer *ib, RenderState *rs, Material *mat, PrimitiveType pt = TRIANGLES);
+
+	private:
+		struct Item {
+			matrix4x4f trans;
+			VertexBuffer *vb;
+			IndexBuffer *ib;
+			RenderState *rs;
+			Material *mat;
+			PrimitiveType pt;
+		};
+
+		void Add(const matrix4x4f &trans, VertexBuffer *vb, IndexBuffer *ib, RenderState *rs, Material *mat, PrimitiveType pt);
+		void Submit(const Item &item);
+		void Flush();
+
+		Renderer *m_renderer;
+		bool m_enabled;
+		unsigned int m_depth;
+		std::vector<Item> m_items;
+		std::vector<std::pair<Uint64, Uint32>> m_keys;
+	};
+
+} // namespace Graphics
+
+#endif
@@ -2,6 +2,7 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "Renderer.h"
+#include "RenderQueue.h"
 #include "Texture.h"
 
 namespace Graphics {
@@ -10,7 +11,8 @@ namespace Graphics {
 		m_width(w),
 		m_height(h),
 		m_ambient(Color::BLACK),
-		m_window(window)
+		m_window(window),
+		m_renderQueue(new RenderQueue(this))
 	{
 	}
 
@@ -22,6 +22,7 @@ namespace Graphics {
 
 	class Material;
 	class MaterialDescriptor;
+	class RenderQueue;
 	class RenderState;
 	class RenderTarget;
 	class Texture;
@@ -69,6 +70,8 @@ namespace Graphics {
 		virtual bool EndFrame() = 0;
 		//traditionally gui happens between endframe and swapbuffers
 		virtual bool SwapBuffers() = 0;
+		//start the GPU on everything submitted so far, without waiting for it
+		virtual bool FlushCommandBuffers() = 0;
 
 		//set 0 to render to screen
 		virtual bool SetRenderTarget(RenderTarget *) = 0;
@@ -209,6 +212,9 @@ namespace Graphics {
 
 		Stats &GetStats() { return m_stats; }
 
+		// sorted submission for scenegraph draws, see RenderQueue.h
+		RenderQueue &GetRenderQueue() { return *m_renderQueue; }
+
 	protected:
 		int m_width;
 		int m_height;
@@ -222,6 +228,7 @@ namespace Graphics {
 
 	private:
 		TextureCacheMap m_textureCache;
+		std::unique_ptr<RenderQueue> m_renderQueue;
 	};
 
 } // namespace Graphics
@@ -18,6 +18,10 @@ namespace Graphics {
 			GetOrCreateCounter("DrawTriangles Calls"),
 			GetOrCreateCounter("DrawPointSprites Calls"),
 
+			GetOrCreateCounter("Program Changes"),
+			GetOrCreateCounter("Material Changes"),
+			GetOrCreateCounter("RenderState Changes"),
+
 			GetOrCreateCounter("Buffers Created"),
 			GetOrCreateCounter("Buffers Destroyed"),
 			GetOrCreateCounter("Buffers In Use", false),
@@ -25,6 +25,11 @@ namespace Graphics {
 			STAT_DRAWTRIS,
 			STAT_DRAWPOINTSPRITES,
 
+			// state changes
+			STAT_PROGRAM_CHANGES,
+			STAT_MATERIAL_CHANGES,
+			STAT_RENDERSTATE_CHANGES,
+
 			// buffers
 			STAT_CREATE_BUFFER,
 			STAT_DESTROY_BUFFER,
@@ -33,6 +33,7 @@ namespace Graphics {
 		virtual bool BeginFrame() override final { return true; }
 		virtual bool EndFrame() override final { return true; }
 		virtual bool SwapBuffers() override final { return true; }
+		virtual bool FlushCommandBuffers() override final { return true; }
 
 		virtual bool SetRenderState(RenderState *) override final { return true; }
 		virtual bool SetRenderTarget(RenderTarget *) override final { return true; }
@@ -23,6 +23,11 @@ namespace Graphics {
 			return m_program->Loaded();
 		}
 
+		Uint32 Material::GetProgramID() const
+		{
+			return m_program ? m_program->GetProgramID() : 0;
+		}
+
 		void Material::SetCommonUniforms(const matrix4x4f &mv, const matrix4x4f &proj)
 		{
 			const matrix4x4f ViewProjection = proj * mv;
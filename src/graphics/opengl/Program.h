@@ -29,6 +29,8 @@ namespace Graphics {
 			virtual void Use();
 			virtual void Unuse();
 			bool Loaded() const { return success; }
+			GLuint GetProgramID() const { return m_program; }
+			static GLuint GetCurrentProgram() { return s_curProgram; }
 
 			// Uniforms.
 			Uniform uProjectionMatrix;
@@ -161,6 +161,7 @@ namespace Graphics {
 		m_invLogZfarPlus1(0.f),
 		m_activeRenderTarget(0),
 		m_activeRenderState(nullptr),
+		m_activeMaterial(nullptr),
 		m_glContext(glContext)
 	{
 		glewExperimental = true;
@@ -513,16 +514,38 @@ namespace Graphics {
 		return true;
 	}
 
+	bool RendererOGL::FlushCommandBuffers()
+	{
+		PROFILE_SCOPED()
+		glFlush();
+		return true;
+	}
+
 	bool RendererOGL::SetRenderState(RenderState *rs)
 	{
 		if (m_activeRenderState != rs) {
 			static_cast<OGL::RenderState *>(rs)->Apply();
 			m_activeRenderState = rs;
+			m_stats.AddToStatCount(Stats::STAT_RENDERSTATE_CHANGES, 1);
 		}
 		CheckRenderErrors(__FUNCTION__, __LINE__);
 		return true;
 	}
 
+	void RendererOGL::ApplyMaterial(Material *mat)
+	{
+		// materials are always reapplied, since their parameters may have
+		// changed, but only a switch to a new material or program is counted
+		const GLuint lastProgram = OGL::Program::GetCurrentProgram();
+		mat->Apply();
+		if (m_activeMaterial != mat) {
+			m_activeMaterial = mat;
+			m_stats.AddToStatCount(Stats::STAT_MATERIAL_CHANGES, 1);
+		}
+		if (OGL::Program::GetCurrentProgram() != lastProgram)
+			m_stats.AddToStatCount(Stats::STAT_PROGRAM_CHANGES, 1);
+	}
+
 	bool RendererOGL::SetRenderTarget(RenderTarget *rt)
 	{
 		PROFILE_SCOPED()
@@ -866,7 +889,7 @@ namespace Graphics {
 	{
 		PROFILE_SCOPED()
 		SetRenderState(state);
-		mat->Apply();
+		ApplyMaterial(mat);
 
 		SetMaterialShaderTransforms(mat);
 
@@ -884,7 +907,7 @@ namespace Graphics {
 	{
 		PROFILE_SCOPED()
 		SetRenderState(state);
-		mat->Apply();
+		ApplyMaterial(mat);
 
 		SetMaterialShaderTransforms(mat);
 
@@ -904,7 +927,7 @@ namespace Graphics {
 	{
 		PROFILE_SCOPED()
 		SetRenderState(state);
-		mat->Apply();
+		ApplyMaterial(mat);
 
 		SetMaterialShaderTransforms(mat);
 
@@ -924,7 +947,7 @@ namespace Graphics {
 	{
 		PROFILE_SCOPED()
 		SetRenderState(state);
-		mat->Apply();
+		ApplyMaterial(mat);
 
 		SetMaterialShaderTransforms(mat);
 
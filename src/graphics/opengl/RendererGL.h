@@ -65,6 +65,7 @@ namespace Graphics {
 		virtual bool BeginFrame() override final;
 		virtual bool EndFrame() override final;
 		virtual bool SwapBuffers() override final;
+		virtual bool FlushCommandBuffers() override final;
 
 		virtual bool SetRenderState(RenderState *) override final;
 		virtual bool SetRenderTarget(RenderTarget *) override final;
@@ -128,6 +129,7 @@ namespace Graphics {
 		bool m_useAnisotropicFiltering;
 
 		void SetMaterialShaderTransforms(Material *);
+		void ApplyMaterial(Material *);
 
 		matrix4x4f &GetCurrentTransform() { return m_currentTransform; }
 		matrix4x4f m_currentTransform;
@@ -150,6 +152,7 @@ namespace Graphics {
 		float m_invLogZfarPlus1;
 		OGL::RenderTarget *m_activeRenderTarget;
 		RenderState *m_activeRenderState;
+		Material *m_activeMaterial;
 
 		matrix4x4f m_modelViewMat;
 		matrix4x4f m_projectionMat;
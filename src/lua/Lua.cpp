@@ -90,6 +90,7 @@ namespace Lua {
 		LuaConstants::Register(Lua::manager->GetLuaState());
 		LuaLang::Register();
 		LuaEngine::Register();
+		LuaEvent::Register();
 		LuaInput::Register();
 		LuaFileSystem::Register();
 		LuaJson::Register();
@@ -0,0 +1,218 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "LuaAllocator.h"
+#include "LuaUtils.h"
+// for the type tags of Lua's internal objects
+extern "C" {
+#include "src/lobject.h"
+}
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+static const char *s_typeNames[] = {
+	"Strings",
+	"Tables",
+	"Functions",
+	"Userdata",
+	"Threads",
+	"Prototypes",
+	"Upvalues",
+	"Other"
+};
+
+LuaAllocator::LuaAllocator() :
+	m_chunkCur(nullptr),
+	m_chunkEnd(nullptr),
+	m_bytesInUse(0),
+	m_highWater(0),
+	m_numFrees(0),
+	m_numSystemAllocs(0),
+	m_freesCounter(nullptr),
+	m_systemAllocsCounter(nullptr),
+	m_inUseCounter(nullptr),
+	m_highWaterCounter(nullptr),
+	m_chunksCounter(nullptr)
+{
+	std::fill(m_freeLists, m_freeLists + NUM_SIZE_CLASSES, nullptr);
+	std::fill(m_numAllocs, m_numAllocs + ALLOC_TYPE_MAX, 0);
+	std::fill(m_bytesAllocated, m_bytesAllocated + ALLOC_TYPE_MAX, 0);
+
+	for (size_t i = 0; i < ALLOC_TYPE_MAX; i++) {
+		m_allocCounters.push_back(m_stats.GetOrCreateCounter(std::string(s_typeNames[i]) + " Allocated"));
+		m_bytesCounters.push_back(m_stats.GetOrCreateCounter(std::string(s_typeNames[i]) + " Allocated (KB)"));
+	}
+	m_freesCounter = m_stats.GetOrCreateCounter("Blocks Freed");
+	m_systemAllocsCounter = m_stats.GetOrCreateCounter("System Allocations");
+	m_inUseCounter = m_stats.GetOrCreateCounter("In Use (KB)", false);
+	m_highWaterCounter = m_stats.GetOrCreateCounter("High Water Mark (KB)", false);
+	m_chunksCounter = m_stats.GetOrCreateCounter("Pool Chunks", false);
+}
+
+LuaAllocator::~LuaAllocator()
+{
+	for (char *chunk : m_chunks)
+		std::free(chunk);
+}
+
+LuaAllocator::AllocType LuaAllocator::TypeOf(size_t luaType)
+{
+	// prototypes and upvalues have tags of their own, past the public types
+	switch (luaType) {
+	case LUA_TPROTO: return ALLOC_PROTO;
+	case LUA_TUPVAL: return ALLOC_UPVALUE;
+	default: break;
+	}
+
+	// the other tags carry a variant in bits 4-5 (long strings, Lua and C
+	// closures), the low bits are the public type
+	switch (luaType & 0x0F) {
+	case LUA_TSTRING: return ALLOC_STRING;
+	case LUA_TTABLE: return ALLOC_TABLE;
+	case LUA_TFUNCTION: return ALLOC_FUNCTION;
+	case LUA_TUSERDATA: return ALLOC_USERDATA;
+	case LUA_TTHREAD: return ALLOC_THREAD;
+	default: return ALLOC_OTHER;
+	}
+}
+
+void *LuaAllocator::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	LuaAllocator *self = static_cast<LuaAllocator *>(ud);
+
+	if (!ptr) {
+		// osize is the type of object being created, not a size
+		if (!nsize) return nullptr;
+		const AllocType type = TypeOf(osize);
+		self->m_numAllocs[type]++;
+		self->m_bytesAllocated[type] += nsize;
+		return self->Allocate(nsize);
+	}
+
+	if (!nsize) {
+		self->m_numFrees++;
+		self->Free(ptr, osize);
+		return nullptr;
+	}
+
+	if (nsize > osize) {
+		self->m_numAllocs[ALLOC_OTHER]++;
+		self->m_bytesAllocated[ALLOC_OTHER] += nsize - osize;
+	}
+	return self->Reallocate(ptr, osize, nsize);
+}
+
+void *LuaAllocator::Allocate(size_t size)
+{
+	void *ptr;
+	if (size <= MAX_POOLED_SIZE)
+		ptr = PoolAllocate(SizeClass(size));
+	else {
+		ptr = std::malloc(size);
+		m_numSystemAllocs++;
+	}
+	if (!ptr) return nullptr;
+
+	m_bytesInUse += size;
+	m_highWater = std::max(m_highWater, m_bytesInUse);
+	return ptr;
+}
+
+void LuaAllocator::Free(void *ptr, size_t size)
+{
+	if (size <= MAX_POOLED_SIZE)
+		PoolFree(ptr, SizeClass(size));
+	else
+		std::free(ptr);
+	m_bytesInUse -= size;
+}
+
+void *LuaAllocator::Reallocate(void *ptr, size_t osize, size_t nsize)
+{
+	if (osize > MAX_POOLED_SIZE && nsize > MAX_POOLED_SIZE) {
+		void *newPtr = std::realloc(ptr, nsize);
+		if (!newPtr) return nullptr;
+		m_numSystemAllocs++;
+		m_bytesInUse = m_bytesInUse - osize + nsize;
+		m_highWater = std::max(m_highWater, m_bytesInUse);
+		return newPtr;
+	}
+
+	// the block already has room for it
+	if (osize <= MAX_POOLED_SIZE && nsize <= MAX_POOLED_SIZE && SizeClass(osize) == SizeClass(nsize)) {
+		m_bytesInUse = m_bytesInUse - osize + nsize;
+		m_highWater = std::max(m_highWater, m_bytesInUse);
+		return ptr;
+	}
+
+	void *newPtr = Allocate(nsize);
+	if (!newPtr) {
+		// Lua assumes shrinking never fails, and the old block is big enough
+		if (nsize < osize) {
+			m_bytesInUse = m_bytesInUse - osize + nsize;
+			return ptr;
+		}
+		return nullptr;
+	}
+
+	memcpy(newPtr, ptr, std::min(osize, nsize));
+	Free(ptr, osize);
+	return newPtr;
+}
+
+void *LuaAllocator::PoolAllocate(size_t sizeClass)
+{
+	FreeBlock *block = m_freeLists[sizeClass];
+	if (block) {
+		m_freeLists[sizeClass] = block->next;
+		return block;
+	}
+
+	const size_t blockSize = (sizeClass + 1) * GRANULE;
+	if (size_t(m_chunkEnd - m_chunkCur) < blockSize) {
+		// the tail of the old chunk is left to the free lists
+		while (m_chunkCur < m_chunkEnd) {
+			const size_t tailClass = std::min(SizeClass(size_t(m_chunkEnd - m_chunkCur)), NUM_SIZE_CLASSES - 1);
+			const size_t tailSize = (tailClass + 1) * GRANULE;
+			PoolFree(m_chunkCur, tailClass);
+			m_chunkCur += tailSize;
+		}
+
+		char *chunk = static_cast<char *>(std::malloc(CHUNK_SIZE));
+		if (!chunk) return nullptr;
+		m_numSystemAllocs++;
+		m_chunks.push_back(chunk);
+		m_chunkCur = chunk;
+		m_chunkEnd = chunk + CHUNK_SIZE;
+	}
+
+	void *ptr = m_chunkCur;
+	m_chunkCur += blockSize;
+	return ptr;
+}
+
+void LuaAllocator::PoolFree(void *ptr, size_t sizeClass)
+{
+	FreeBlock *block = static_cast<FreeBlock *>(ptr);
+	block->next = m_freeLists[sizeClass];
+	m_freeLists[sizeClass] = block;
+}
+
+void LuaAllocator::UpdateStats()
+{
+	for (size_t i = 0; i < ALLOC_TYPE_MAX; i++) {
+		m_stats.CounterSet(m_allocCounters[i], uint32_t(m_numAllocs[i]));
+		m_stats.CounterSet(m_bytesCounters[i], uint32_t(m_bytesAllocated[i] / 1024));
+		m_numAllocs[i] = 0;
+		m_bytesAllocated[i] = 0;
+	}
+	m_stats.CounterSet(m_freesCounter, uint32_t(m_numFrees));
+	m_stats.CounterSet(m_systemAllocsCounter, uint32_t(m_numSystemAllocs));
+	m_numFrees = 0;
+	m_numSystemAllocs = 0;
+
+	m_stats.CounterSet(m_inUseCounter, uint32_t(m_bytesInUse / 1024));
+	m_stats.CounterSet(m_highWaterCounter, uint32_t(m_highWater / 1024));
+	m_stats.CounterSet(m_chunksCounter, uint32_t(m_chunks.size()));
+}
@@ -0,0 +1,96 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _LUAALLOCATOR_H
+#define _LUAALLOCATOR_H
+
+#include "PerfStats.h"
+#include <cstddef>
+#include <vector>
+
+/*
+ * Memory allocator for the Lua state. Nearly everything Lua allocates is
+ * small (strings, tables, closures, upvalues, Vector3 userdata), so blocks
+ * of up to MAX_POOLED_SIZE bytes come from per-size-class free lists carved
+ * out of large chunks, and only bigger blocks go to the system allocator.
+ * Chunks are only released when the allocator is destroyed.
+ *
+ * A Lua state may only be used from one thread at a time, so the pools
+ * belong to the allocator and need no locking.
+ */
+class LuaAllocator {
+public:
+	LuaAllocator();
+	~LuaAllocator();
+
+	// lua_Alloc, with the allocator as its user data
+	static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+	size_t GetBytesInUse() const { return m_bytesInUse; }
+	size_t GetHighWaterMark() const { return m_highWater; }
+
+	// copies the counts gathered since the last call into the stats
+	void UpdateStats();
+	Perf::Stats &GetStats() { return m_stats; }
+
+private:
+	LuaAllocator(const LuaAllocator &) = delete;
+	LuaAllocator &operator=(const LuaAllocator &) = delete;
+
+	static const size_t GRANULE = 16; // matches the alignment of malloc
+	static const size_t MAX_POOLED_SIZE = 256;
+	static const size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / GRANULE;
+	static const size_t CHUNK_SIZE = 64 * 1024;
+
+	// what a new block is for, from the type Lua passes when allocating
+	enum AllocType {
+		ALLOC_STRING,
+		ALLOC_TABLE,
+		ALLOC_FUNCTION,
+		ALLOC_USERDATA,
+		ALLOC_THREAD,
+		ALLOC_PROTO,
+		ALLOC_UPVALUE,
+		ALLOC_OTHER, // arrays, buffers and anything resized
+		ALLOC_TYPE_MAX
+	};
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	static size_t SizeClass(size_t size) { return (size - 1) / GRANULE; }
+	static AllocType TypeOf(size_t luaType);
+
+	void *Allocate(size_t size);
+	void Free(void *ptr, size_t size);
+	void *Reallocate(void *ptr, size_t osize, size_t nsize);
+
+	void *PoolAllocate(size_t sizeClass);
+	void PoolFree(void *ptr, size_t sizeClass);
+
+	FreeBlock *m_freeLists[NUM_SIZE_CLASSES];
+	std::vector<char *> m_chunks;
+	char *m_chunkCur;
+	char *m_chunkEnd;
+
+	size_t m_bytesInUse;
+	size_t m_highWater;
+
+	// since the last UpdateStats()
+	size_t m_numAllocs[ALLOC_TYPE_MAX];
+	size_t m_bytesAllocated[ALLOC_TYPE_MAX];
+	size_t m_numFrees;
+	size_t m_numSystemAllocs;
+
+	Perf::Stats m_stats;
+	std::vector<Perf::Stats::CounterRef> m_allocCounters;
+	std::vector<Perf::Stats::CounterRef> m_bytesCounters;
+	Perf::Stats::CounterRef m_freesCounter;
+	Perf::Stats::CounterRef m_systemAllocsCounter;
+	Perf::Stats::CounterRef m_inUseCounter;
+	Perf::Stats::CounterRef m_highWaterCounter;
+	Perf::Stats::CounterRef m_chunksCounter;
+};
+
+#endif
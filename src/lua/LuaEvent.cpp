@@ -4,66 +4,339 @@
 #include "LuaEvent.h"
 #include "LuaManager.h"
 #include "LuaObject.h"
+#include "LuaProfiler.h"
 #include "LuaUtils.h"
 #include "libs.h"
+#include <map>
+#include <unordered_map>
+
+/*
+ * The event queue lives on the C++ side. Each event type has a subscriber
+ * table (callback -> callback) in the registry and a subscriber count, so an
+ * event nobody listens for costs a lookup and nothing else. The arguments of
+ * queued events are stored in a single registry table, in queue order, since
+ * the objects they refer to may be gone by the time the queue is emitted;
+ * LuaObject keeps the Lua side of them alive until then.
+ */
 
 namespace LuaEvent {
 
-	static bool _get_method_onto_stack(lua_State *l, const char *method)
+	struct EventType {
+		EventType(const std::string &_name, int _callbacks) :
+			name(_name),
+			callbacks(_callbacks),
+			listeners(0),
+			debugTimer(false),
+			queued(s_stats.GetOrCreateCounter(_name + " Queued")),
+			dropped(s_stats.GetOrCreateCounter(_name + " Dropped")) {}
+
+		std::string name;
+		int callbacks; // registry ref to the subscriber table
+		Uint32 listeners;
+		bool debugTimer;
+		Perf::Stats::CounterRef queued;
+		Perf::Stats::CounterRef dropped;
+
+		static Perf::Stats s_stats;
+	};
+
+	Perf::Stats EventType::s_stats;
+
+	struct PendingEvent {
+		Uint32 type;
+		Uint32 firstArg;
+		Uint32 numArgs;
+	};
+
+	static std::vector<EventType> s_types;
+	static std::map<std::string, Uint32> s_typeIndex;
+	static std::unordered_map<const char *, Uint32> s_literalIndex;
+
+	// events are appended while the queue is emitted, so this is drained from
+	// s_pendingHead and only reset once it is empty
+	static std::vector<PendingEvent> s_pending;
+	static size_t s_pendingHead = 0;
+	static bool s_emitting = false;
+
+	static int s_argsRef = LUA_NOREF;
+	static Uint32 s_argTop = 0;
+
+	static Perf::Stats::CounterRef s_dispatchedCounter(nullptr);
+	static Perf::Stats::CounterRef s_callbacksCounter(nullptr);
+
+	Perf::Stats &GetStats()
+	{
+		return EventType::s_stats;
+	}
+
+	static Uint32 _get_type(lua_State *l, const std::string &name)
+	{
+		auto it = s_typeIndex.find(name);
+		if (it != s_typeIndex.end())
+			return it->second;
+
+		lua_newtable(l);
+		const Uint32 id = Uint32(s_types.size());
+		s_types.emplace_back(name, luaL_ref(l, LUA_REGISTRYINDEX));
+		s_typeIndex.emplace(name, id);
+		return id;
+	}
+
+	static Uint32 _get_type(lua_State *l, const char *name)
+	{
+		auto it = s_literalIndex.find(name);
+		if (it != s_literalIndex.end() && s_types[it->second].name == name)
+			return it->second;
+
+		const Uint32 id = _get_type(l, std::string(name));
+		s_literalIndex[name] = id;
+		return id;
+	}
+
+	// pops the top numArgs values off the stack and appends them to the
+	// pending queue as an event of the given type
+	static void _queue_from_stack(lua_State *l, Uint32 type, int numArgs)
 	{
 		LUA_DEBUG_START(l);
 
-		int top = lua_gettop(l);
+		lua_rawgeti(l, LUA_REGISTRYINDEX, s_argsRef);
+		lua_insert(l, -1 - numArgs);
+		for (int i = numArgs; i > 0; i--)
+			lua_rawseti(l, -1 - i, s_argTop + i);
+		lua_pop(l, 1);
 
-		if (!pi_lua_import(l, "Event"))
-			return false;
+		s_pending.push_back({ type, s_argTop + 1, Uint32(numArgs) });
+		s_argTop += numArgs;
 
-		lua_getfield(l, -1, method);
-		if (!lua_isfunction(l, -1)) {
-			lua_pop(l, 2);
+		LUA_DEBUG_END(l, -numArgs);
+	}
+
+	static void _call_timed(lua_State *l, const EventType &type, int numArgs)
+	{
+		lua_Debug ar;
+		lua_pushvalue(l, -1 - numArgs);
+		lua_getinfo(l, ">S", &ar);
+
+		const Uint32 start = SDL_GetTicks();
+		pi_lua_protected_call(l, numArgs, 0);
+		const Uint32 end = SDL_GetTicks();
+
+		Output("DEBUG: %s %ums %s:%d\n", type.name.c_str(), end - start, ar.source, ar.linedefined);
+	}
+
+	static void _dispatch(lua_State *l, const PendingEvent &ev, int argsIdx)
+	{
+		LUA_DEBUG_START(l);
+
+		const EventType &type = s_types[ev.type];
+		if (!type.listeners) {
 			LUA_DEBUG_END(l, 0);
-			return false;
+			return;
 		}
 
-		lua_insert(l, top + 1);
-		lua_settop(l, top + 1);
+		LuaProfiler::Scope profilerScope(type.name);
+
+		// snapshot the subscribers, callbacks may register or deregister.
+		// new ones wait for the next event
+		lua_checkstack(l, int(type.listeners + ev.numArgs) + LUA_MINSTACK);
+		lua_rawgeti(l, LUA_REGISTRYINDEX, type.callbacks);
+		const int callbacks = lua_gettop(l);
+		lua_pushnil(l);
+		while (lua_next(l, callbacks))
+			lua_insert(l, -2); // keep the value, continue from the key
 
-		LUA_DEBUG_END(l, 1);
+		Uint32 called = 0;
+		for (int cb = callbacks + 1; cb <= lua_gettop(l); cb++) {
+			// skip anything deregistered by an earlier callback of this event
+			lua_pushvalue(l, cb);
+			lua_rawget(l, callbacks);
+			const bool registered = !lua_isnil(l, -1);
+			lua_pop(l, 1);
+			if (!registered)
+				continue;
 
-		return true;
+			lua_pushvalue(l, cb);
+			for (Uint32 i = 0; i < ev.numArgs; i++)
+				lua_rawgeti(l, argsIdx, ev.firstArg + i);
+
+			// looked up again, callbacks may have created new types
+			if (s_types[ev.type].debugTimer)
+				_call_timed(l, s_types[ev.type], ev.numArgs);
+			else
+				pi_lua_protected_call(l, ev.numArgs, 0);
+			called++;
+		}
+		EventType::s_stats.CounterAdd(s_callbacksCounter, called);
+		lua_settop(l, callbacks - 1);
+
+		LUA_DEBUG_END(l, 0);
 	}
 
 	void Clear()
 	{
-		lua_State *l = Lua::manager->GetLuaState();
+		s_pending.clear();
+		s_pendingHead = 0;
 
+		lua_State *l = Lua::manager->GetLuaState();
 		LUA_DEBUG_START(l);
-		if (!_get_method_onto_stack(l, "_Clear")) return;
-		pi_lua_protected_call(l, 0, 0);
+
+		if (s_argTop) {
+			lua_newtable(l);
+			lua_rawseti(l, LUA_REGISTRYINDEX, s_argsRef);
+			s_argTop = 0;
+		}
+
 		LUA_DEBUG_END(l, 0);
 	}
 
 	void Emit()
 	{
+		// anything queued by callbacks is picked up by the outer loop
+		if (s_emitting || s_pending.empty())
+			return;
+
+		PROFILE_SCOPED()
 		lua_State *l = Lua::manager->GetLuaState();
 
 		LUA_DEBUG_START(l);
-		if (!_get_method_onto_stack(l, "_Emit")) return;
-		pi_lua_protected_call(l, 0, 0);
+
+		s_emitting = true;
+		lua_rawgeti(l, LUA_REGISTRYINDEX, s_argsRef);
+		const int argsIdx = lua_gettop(l);
+
+		while (s_pendingHead < s_pending.size()) {
+			// copied, the queue may grow during the callbacks
+			const PendingEvent ev = s_pending[s_pendingHead++];
+			_dispatch(l, ev, argsIdx);
+			EventType::s_stats.CounterAdd(s_dispatchedCounter);
+		}
+		lua_pop(l, 1);
+		s_emitting = false;
+
+		Clear();
+
 		LUA_DEBUG_END(l, 0);
 	}
 
 	void Queue(const char *event, const ArgsBase &args)
 	{
 		lua_State *l = Lua::manager->GetLuaState();
+		const Uint32 type = _get_type(l, event);
+		if (!s_types[type].listeners) {
+			EventType::s_stats.CounterAdd(s_types[type].dropped);
+			return;
+		}
 
 		LUA_DEBUG_START(l);
-		if (!_get_method_onto_stack(l, "Queue")) return;
 
-		int top = lua_gettop(l);
-		lua_pushstring(l, event);
+		const int top = lua_gettop(l);
 		args.PrepareStack();
-		pi_lua_protected_call(l, lua_gettop(l) - top, 0);
+		_queue_from_stack(l, type, lua_gettop(l) - top);
+		EventType::s_stats.CounterAdd(s_types[type].queued);
+
+		LUA_DEBUG_END(l, 0);
+	}
+
+	static int l_event_register(lua_State *l)
+	{
+		const std::string name = luaL_checkstring(l, 1);
+		luaL_checkany(l, 2);
+
+		EventType &type = s_types[_get_type(l, name)];
+		lua_rawgeti(l, LUA_REGISTRYINDEX, type.callbacks);
+		lua_pushvalue(l, 2);
+		lua_rawget(l, -2);
+		if (lua_isnil(l, -1)) {
+			lua_pushvalue(l, 2);
+			lua_pushvalue(l, 2);
+			lua_rawset(l, -4);
+			type.listeners++;
+		}
+		lua_pop(l, 2);
+
+		return 0;
+	}
+
+	static int l_event_deregister(lua_State *l)
+	{
+		const std::string name = luaL_checkstring(l, 1);
+		luaL_checkany(l, 2);
+
+		auto it = s_typeIndex.find(name);
+		if (it == s_typeIndex.end())
+			return 0;
+
+		EventType &type = s_types[it->second];
+		lua_rawgeti(l, LUA_REGISTRYINDEX, type.callbacks);
+		lua_pushvalue(l, 2);
+		lua_rawget(l, -2);
+		if (!lua_isnil(l, -1)) {
+			lua_pushvalue(l, 2);
+			lua_pushnil(l);
+			lua_rawset(l, -4);
+			type.listeners--;
+		}
+		lua_pop(l, 2);
+
+		return 0;
+	}
+
+	static int l_event_queue(lua_State *l)
+	{
+		const std::string name = luaL_checkstring(l, 1);
+
+		const Uint32 type = _get_type(l, name);
+		if (!s_types[type].listeners) {
+			EventType::s_stats.CounterAdd(s_types[type].dropped);
+			return 0;
+		}
+
+		_queue_from_stack(l, type, lua_gettop(l) - 1);
+		EventType::s_stats.CounterAdd(s_types[type].queued);
+
+		return 0;
+	}
+
+	static int l_event_debug_timer(lua_State *l)
+	{
+		const std::string name = luaL_checkstring(l, 1);
+		s_types[_get_type(l, name)].debugTimer = lua_toboolean(l, 2);
+		return 0;
+	}
+
+	void Register()
+	{
+		lua_State *l = Lua::manager->GetLuaState();
+
+		LUA_DEBUG_START(l);
+
+		// the registry refs belong to the previous Lua state, if any
+		s_types.clear();
+		s_typeIndex.clear();
+		s_literalIndex.clear();
+		s_pending.clear();
+		s_pendingHead = 0;
+		s_emitting = false;
+
+		lua_newtable(l);
+		s_argsRef = luaL_ref(l, LUA_REGISTRYINDEX);
+		s_argTop = 0;
+
+		s_dispatchedCounter = EventType::s_stats.GetOrCreateCounter("Events Dispatched");
+		s_callbacksCounter = EventType::s_stats.GetOrCreateCounter("Callbacks Called");
+
+		static const luaL_Reg l_methods[] = {
+			{ "Register", l_event_register },
+			{ "Deregister", l_event_deregister },
+			{ "Queue", l_event_queue },
+			{ "DebugTimer", l_event_debug_timer },
+			{ 0, 0 }
+		};
+
+		lua_getfield(l, LUA_REGISTRYINDEX, "CoreImports");
+		LuaObjectBase::CreateObject(l_methods, 0, 0);
+		lua_setfield(l, -2, "Event");
+		lua_pop(l, 1);
 
 		LUA_DEBUG_END(l, 0);
 	}
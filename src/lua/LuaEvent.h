@@ -7,6 +7,7 @@
 #include "DeleteEmitter.h"
 #include "Lua.h"
 #include "LuaObject.h"
+#include "PerfStats.h"
 #include "Pi.h"
 
 namespace LuaEvent {
@@ -78,11 +79,20 @@ namespace LuaEvent {
 		inline void PrepareStack() const {}
 	};
 
+	// creates the native Event module and resets the event types and queue.
+	// must be called (again) whenever a new Lua state is created
+	void Register();
+
 	void Clear();
 	void Emit();
 
+	// events are only stored if something is registered for their type,
+	// otherwise they're dropped before any Lua work is done. event names are
+	// normally string literals, which are looked up by pointer first
 	void Queue(const char *event, const ArgsBase &args);
 
+	Perf::Stats &GetStats();
+
 	template <typename T0, typename T1>
 	void Queue(const char *event, T0 *arg0, T1 *arg1)
 	{
@@ -3,21 +3,37 @@
 
 #include "LuaManager.h"
 #include "FileSystem.h"
+#include "profiler/Profiler.h"
 #include <cstdlib>
 
 bool instantiated = false;
 
+// Lua starts a cycle on its own once memory use reaches this percentage of
+// what was left after the last one; the frame loop starts one much earlier
+static const int LUA_GC_PAUSE = 400;
+// percentage of growth after a finished cycle before another is started
+static const size_t GC_RESTART_GROWTH = 150;
+// work done per step, in KB of allocation "paid back"
+static const int GC_STEP_SIZE = 8;
+
 LuaManager::LuaManager() :
-	m_lua(0)
+	m_lua(0),
+	m_gcEstimate(0),
+	m_gcCycleRunning(false),
+	m_gcTimeCounter(m_gcStats.GetOrCreateCounter("GC Time (us)")),
+	m_gcStepsCounter(m_gcStats.GetOrCreateCounter("GC Steps")),
+	m_gcCyclesCounter(m_gcStats.GetOrCreateCounter("GC Cycles Completed")),
+	m_gcBudgetCounter(m_gcStats.GetOrCreateCounter("GC Budget (us)"))
 {
 	if (instantiated) {
 		Output("Can't instantiate more than one LuaManager");
 		abort();
 	}
 
-	m_lua = luaL_newstate();
+	m_lua = lua_newstate(LuaAllocator::Alloc, &m_allocator);
 	pi_lua_open_standard_base(m_lua);
 	lua_atpanic(m_lua, pi_lua_panic);
+	lua_gc(m_lua, LUA_GCSETPAUSE, LUA_GC_PAUSE);
 
 	// this will print nothing currently because there's no stack yet, but it means that the function is included
 	// in the codebase and thus available via the "immediate" window in the MSVC debugger for us in any C++ lua function
@@ -43,4 +59,37 @@ size_t LuaManager::GetMemoryUsage() const
 void LuaManager::CollectGarbage()
 {
 	lua_gc(m_lua, LUA_GCCOLLECT, 0);
+	m_gcEstimate = GetMemoryUsage();
+	m_gcCycleRunning = false;
+}
+
+void LuaManager::StepGarbageCollector(float budgetMs)
+{
+	PROFILE_SCOPED()
+	m_gcStats.CounterAdd(m_gcBudgetCounter, Uint32(budgetMs * 1e3f));
+
+	// between cycles, wait for enough garbage to be worth collecting. a cycle
+	// that is under way always gets its budget, or it would never finish
+	if (!m_gcCycleRunning && GetMemoryUsage() * 100 < m_gcEstimate * GC_RESTART_GROWTH)
+		return;
+
+	Profiler::Clock timer;
+	timer.SoftReset();
+	Uint32 steps = 0;
+	bool finished;
+	do {
+		steps++;
+		finished = lua_gc(m_lua, LUA_GCSTEP, GC_STEP_SIZE) != 0;
+		timer.SoftStop();
+	} while (!finished && timer.milliseconds() < budgetMs);
+
+	// the next cycle waits for the heap to grow again
+	m_gcCycleRunning = !finished;
+	if (finished) {
+		m_gcEstimate = GetMemoryUsage();
+		m_gcStats.CounterAdd(m_gcCyclesCounter);
+	}
+
+	m_gcStats.CounterAdd(m_gcStepsCounter, steps);
+	m_gcStats.CounterAdd(m_gcTimeCounter, Uint32(timer.milliseconds() * 1e3));
 }
@@ -4,7 +4,9 @@
 #ifndef _LUAMANAGER_H
 #define _LUAMANAGER_H
 
+#include "LuaAllocator.h"
 #include "LuaUtils.h"
+#include "PerfStats.h"
 
 class LuaManager {
 public:
@@ -13,13 +15,32 @@ public:
 
 	lua_State *GetLuaState() { return m_lua; }
 	size_t GetMemoryUsage() const;
+	LuaAllocator &GetAllocator() { return m_allocator; }
 	void CollectGarbage();
 
+	// runs incremental collection steps for up to budgetMs. Lua's own pacing
+	// is only a backstop, the collector is meant to be driven once per frame
+	void StepGarbageCollector(float budgetMs);
+	Perf::Stats &GetGCStats() { return m_gcStats; }
+
 private:
 	LuaManager(const LuaManager &);
 	LuaManager &operator=(const LuaManager &) = delete;
 
+	// must outlive the state
+	LuaAllocator m_allocator;
 	lua_State *m_lua;
+
+	// memory in use when the last collection cycle finished
+	size_t m_gcEstimate;
+	// a collection cycle was started and hasn't finished yet
+	bool m_gcCycleRunning;
+
+	Perf::Stats m_gcStats;
+	Perf::Stats::CounterRef m_gcTimeCounter;
+	Perf::Stats::CounterRef m_gcStepsCounter;
+	Perf::Stats::CounterRef m_gcCyclesCounter;
+	Perf::Stats::CounterRef m_gcBudgetCounter;
 };
 
 #endif
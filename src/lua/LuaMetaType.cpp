@@ -109,6 +109,7 @@ static int l_index(lua_State *l)
 	// normal userdata object
 	// first check properties. we don't need to drill through lua if the
 	// property is already available
+	PropertyMap::SyncLuaTables();
 	lua_getuservalue(l, 1);
 	if (!lua_isnil(l, -1)) {
 		lua_pushvalue(l, 2); // push the key
@@ -172,6 +173,7 @@ static int l_newindex(lua_State *l)
 
 	// first check properties. we don't need to drill through the metatype stack
 	// if the property is already available
+	PropertyMap::SyncLuaTables();
 	lua_getuservalue(l, 1);
 
 	// Ensure the object already has the property defined
@@ -345,6 +347,7 @@ void LuaMetaTypeBase::GetNames(std::vector<std::string> &names, const std::strin
 
 	// properties
 	if (!methodsOnly) {
+		PropertyMap::SyncLuaTables();
 		lua_getuservalue(l, -1);
 		if (!lua_isnil(l, -1))
 			get_names_from_table(l, names, prefix, false);
@@ -131,6 +131,7 @@ int LuaObjectHelpers::l_hasprop(lua_State *l)
 {
 	luaL_checktype(l, 1, LUA_TUSERDATA);
 	luaL_checktype(l, 2, LUA_TSTRING);
+	PropertyMap::SyncLuaTables();
 	lua_getuservalue(l, 1);
 
 	if (lua_isnil(l, -1)) { // Doesn't have properties
@@ -163,10 +164,7 @@ int LuaObjectHelpers::l_unsetprop(lua_State *l)
 	PropertiedObject *po = dynamic_cast<PropertiedObject *>(o);
 	assert(po);
 
-	po->Properties().PushLuaTable();
-	lua_pushvalue(l, 2);
-	lua_pushnil(l);
-	lua_settable(l, -3);
+	po->Properties().Unset(key);
 
 	return 0;
 }
@@ -321,6 +319,11 @@ void LuaObjectBase::CreateObject(const luaL_Reg *methods, const luaL_Reg *attrs,
 	LUA_DEBUG_END(l, 1);
 }
 
+// the registry is looked up on every push, so it is kept by reference
+// rather than by name
+static lua_State *s_registryState = nullptr;
+static int s_registryRef = LUA_NOREF;
+
 static void initialize_object_registry(lua_State *l)
 {
 	// create the object registry if it doesn't already exist. this is the
@@ -328,6 +331,8 @@ static void initialize_object_registry(lua_State *l)
 	// before any objects actually turn up
 	lua_getfield(l, LUA_REGISTRYINDEX, "LuaObjectRegistry");
 	if (lua_isnil(l, -1)) {
+		lua_pop(l, 1);
+
 		// create the LuaObjectRegistry table
 		lua_newtable(l);
 
@@ -338,11 +343,23 @@ static void initialize_object_registry(lua_State *l)
 		lua_rawset(l, -3);
 		lua_setmetatable(l, -2);
 
+		lua_pushvalue(l, -1);
 		lua_setfield(l, LUA_REGISTRYINDEX, "LuaObjectRegistry");
+
+		// a new Lua state, or the first class in this one
+		lua_pushvalue(l, -1);
+		s_registryRef = luaL_ref(l, LUA_REGISTRYINDEX);
+		s_registryState = l;
 	}
 	lua_pop(l, 1);
 }
 
+static inline void push_object_registry(lua_State *l)
+{
+	assert(l == s_registryState);
+	lua_rawgeti(l, LUA_REGISTRYINDEX, s_registryRef);
+}
+
 void LuaObjectBase::CreateClass(const char *type, const char *parent, const luaL_Reg *methods, const luaL_Reg *attrs, const luaL_Reg *meta)
 {
 	assert(type);
@@ -460,15 +477,14 @@ bool LuaObjectBase::PushRegistered(LuaWrappable *o)
 		return true;
 	}
 
-	lua_getfield(l, LUA_REGISTRYINDEX, "LuaObjectRegistry");
+	push_object_registry(l);
 	assert(lua_istable(l, -1));
 
-	lua_pushlightuserdata(l, o);
-	lua_gettable(l, -2);
+	// the registry has no metamethods other than __mode
+	lua_rawgetp(l, -1, o);
 
 	if (lua_isuserdata(l, -1)) {
-		lua_insert(l, -2);
-		lua_pop(l, 1);
+		lua_replace(l, -2);
 
 		LUA_DEBUG_END(l, 1);
 
@@ -514,12 +530,11 @@ void LuaObjectBase::Register(LuaObjectBase *lo)
 
 	LUA_DEBUG_START(l); // lo userdata
 
-	lua_getfield(l, LUA_REGISTRYINDEX, "LuaObjectRegistry"); // lo userdata, registry table
+	push_object_registry(l); // lo userdata, registry table
 	assert(lua_istable(l, -1));
 
-	lua_pushlightuserdata(l, lo->GetObject()); // lo userdata, registry table, o lightuserdata
-	lua_pushvalue(l, -3);					   // lo userdata, registry table, o lightuserdata, lo userdata
-	lua_settable(l, -3);					   // lo userdata, registry table
+	lua_pushvalue(l, -2);				 // lo userdata, registry table, lo userdata
+	lua_rawsetp(l, -2, lo->GetObject()); // lo userdata, registry table
 
 	lua_pop(l, 1); // lo userdata
 
@@ -571,12 +586,11 @@ void LuaObjectBase::Deregister(LuaObjectBase *lo)
 
 	LUA_DEBUG_START(l);
 
-	lua_getfield(l, LUA_REGISTRYINDEX, "LuaObjectRegistry");
+	push_object_registry(l);
 	assert(lua_istable(l, -1));
 
-	lua_pushlightuserdata(l, o);
 	lua_pushnil(l);
-	lua_rawset(l, -3);
+	lua_rawsetp(l, -2, o);
 
 	lua_pop(l, 1);
 
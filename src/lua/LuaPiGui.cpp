@@ -1751,10 +1751,6 @@ bool PiGUI::first_body_is_more_important_than(Body *body, Body *other)
 		result = true;
 	else if (b == Object::Type::MISSILE)
 		result = false;
-	else if (a == Object::Type::PROJECTILE)
-		result = true;
-	else if (b == Object::Type::PROJECTILE)
-		result = false;
 	else
 		Error("don't know how to compare %i and %i\n", a, b);
 
@@ -1809,7 +1805,6 @@ static int l_pigui_get_projected_bodies_grouped(lua_State *l)
 
 	for (Body *body : Pi::game->GetSpace()->GetBodies()) {
 		if (body == Pi::game->GetPlayer()) continue;
-		if (body->GetType() == Object::PROJECTILE) continue;
 		if (body->GetType() == Object::SHIP &&
 			body->GetPositionRelTo(Pi::player).Length() > ship_max_distance) continue;
 		const PiGUI::TScreenSpace res = lua_world_space_to_screen_space(body); // defined in LuaPiGui.cpp
@@ -1914,7 +1909,6 @@ static int l_pigui_get_projected_bodies(lua_State *l)
 	filtered.reserve(Pi::game->GetSpace()->GetNumBodies());
 	for (Body *body : Pi::game->GetSpace()->GetBodies()) {
 		if (body == Pi::game->GetPlayer()) continue;
-		if (body->GetType() == Object::PROJECTILE) continue;
 		const PiGUI::TScreenSpace res = lua_world_space_to_screen_space(body); // defined in LuaPiGui.cpp
 		if (!res._onScreen) continue;
 		filtered.emplace_back(res);
@@ -1946,7 +1940,6 @@ static int l_pigui_get_targets_nearby(lua_State *l)
 	filtered.reserve(nearby.size());
 	for (Body *body : nearby) {
 		if (body == Pi::player) continue;
-		if (body->GetType() == Object::PROJECTILE) continue;
 		filtered.push_back(body);
 	};
 
@@ -2186,10 +2179,13 @@ static int l_pigui_is_mouse_hovering_rect(lua_State *l)
 	return 1;
 }
 
+// joins the components into a path in the game data, which is what
+// LoadTextureFromSVG takes. it is not a file system path: the data may be
+// packed, or overridden from the user data dir
 static int l_pigui_data_dir_path(lua_State *l)
 {
 	PROFILE_SCOPED()
-	std::string path = FileSystem::GetDataDir();
+	std::string path;
 	LuaTable pathComponents(l, 1);
 	for (LuaTable::VecIter<std::string> iter = pathComponents.Begin<std::string>(); iter != pathComponents.End<std::string>(); ++iter) {
 		path = FileSystem::JoinPath(path, *iter);
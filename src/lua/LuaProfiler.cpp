@@ -0,0 +1,201 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "LuaProfiler.h"
+#include "FileSystem.h"
+#include "LuaUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <unordered_map>
+
+namespace LuaProfiler {
+
+	using Clock = std::chrono::steady_clock;
+
+	// instructions between samples
+	static const int SAMPLE_INTERVAL = 500;
+	// deeper stacks are cut short in the flame graph
+	static const int MAX_STACK_DEPTH = 64;
+
+	static const char *PROFILE_DIR = "profiler";
+
+	static bool s_running = false;
+	static int s_scopeDepth = 0;
+	static Clock::time_point s_lastSample;
+
+	static std::vector<std::string> s_entryPoints;
+
+	static std::unordered_map<std::string, double> s_times[CATEGORY_MAX];
+	static std::unordered_map<std::string, double> s_stacks;
+	static double s_totalTime = 0.0;
+
+	// chunk names are "@path" or "[T] @path" for trusted code
+	static std::string ChunkPath(const char *source)
+	{
+		const char *at = strchr(source, '@');
+		return at ? std::string(at + 1) : std::string("?");
+	}
+
+	static std::string ModuleName(const std::string &path)
+	{
+		// one module per file or directory in modules/ and pigui/modules/
+		for (const char *prefix : { "modules/", "pigui/modules/" }) {
+			if (starts_with(path, prefix)) {
+				const size_t start = strlen(prefix);
+				size_t end = path.find('/', start);
+				if (end == std::string::npos)
+					end = ends_with(path, ".lua") ? path.size() - 4 : path.size();
+				return path.substr(0, end);
+			}
+		}
+
+		// everything else by its top directory: libs, pigui, ui...
+		const size_t slash = path.find('/');
+		return slash == std::string::npos ? path : path.substr(0, slash);
+	}
+
+	static std::string FrameName(const lua_Debug &ar)
+	{
+		if (ar.what[0] == 'C')
+			return std::string("[C] ") + (ar.name ? ar.name : "?");
+		return std::string(ar.name ? ar.name : (ar.what[0] == 'm' ? "main" : "?")) +
+			" (" + ChunkPath(ar.source) + ":" + std::to_string(ar.linedefined) + ")";
+	}
+
+	static void Hook(lua_State *l, lua_Debug *)
+	{
+		const Clock::time_point now = Clock::now();
+		const double ms = std::chrono::duration<double, std::milli>(now - s_lastSample).count();
+		s_lastSample = now;
+
+		// innermost first
+		std::vector<lua_Debug> frames;
+		lua_Debug ar;
+		for (int level = 0; level < MAX_STACK_DEPTH && lua_getstack(l, level, &ar); level++) {
+			lua_getinfo(l, "Sln", &ar);
+			frames.push_back(ar);
+		}
+		if (frames.empty())
+			return;
+
+		const std::string &entryPoint = s_entryPoints.empty() ? std::string("(none)") : s_entryPoints.back();
+
+		std::string stack = entryPoint;
+		std::string module;
+		for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+			stack += ';';
+			stack += FrameName(*it);
+			if (module.empty() && it->what[0] != 'C')
+				module = ModuleName(ChunkPath(it->source));
+		}
+
+		// the innermost Lua function, not any C function it called
+		auto top = std::find_if(frames.begin(), frames.end(), [](const lua_Debug &f) { return f.what[0] != 'C'; });
+		if (top == frames.end())
+			top = frames.begin();
+
+		s_times[CATEGORY_FUNCTION][FrameName(*top)] += ms;
+		s_times[CATEGORY_LINE][ChunkPath(top->source) + ":" + std::to_string(top->currentline)] += ms;
+		s_times[CATEGORY_MODULE][module.empty() ? "[C]" : module] += ms;
+		s_times[CATEGORY_ENTRY_POINT][entryPoint] += ms;
+		s_stacks[stack] += ms;
+		s_totalTime += ms;
+	}
+
+	void Start(lua_State *l)
+	{
+		if (s_running) return;
+		s_running = true;
+		s_lastSample = Clock::now();
+		lua_sethook(l, Hook, LUA_MASKCOUNT, SAMPLE_INTERVAL);
+		Output("Lua profiler started\n");
+	}
+
+	void Stop(lua_State *l)
+	{
+		if (!s_running) return;
+		s_running = false;
+		lua_sethook(l, nullptr, 0, 0);
+		Output("Lua profiler stopped, %.1fms sampled\n", s_totalTime);
+	}
+
+	bool IsRunning()
+	{
+		return s_running;
+	}
+
+	void Clear()
+	{
+		for (auto &times : s_times)
+			times.clear();
+		s_stacks.clear();
+		s_totalTime = 0.0;
+	}
+
+	double GetTotalTime()
+	{
+		return s_totalTime;
+	}
+
+	std::vector<std::pair<std::string, double>> GetTop(Category category, size_t count)
+	{
+		std::vector<std::pair<std::string, double>> top(s_times[category].begin(), s_times[category].end());
+		count = std::min(count, top.size());
+		std::partial_sort(top.begin(), top.begin() + count, top.end(),
+			[](const std::pair<std::string, double> &a, const std::pair<std::string, double> &b) { return a.second > b.second; });
+		top.resize(count);
+		return top;
+	}
+
+	std::string WriteFlameGraph()
+	{
+		char name[64];
+		const time_t t = time(0);
+		strftime(name, sizeof(name), "lua-%Y%m%d-%H%M%S.folded", localtime(&t));
+		const std::string path = FileSystem::JoinPathBelow(PROFILE_DIR, name);
+
+		FILE *f = nullptr;
+		if (FileSystem::userFiles.MakeDirectory(PROFILE_DIR))
+			f = FileSystem::userFiles.OpenWriteStream(path);
+		if (!f) {
+			Output("Lua profiler: couldn't open '%s' for writing\n", path.c_str());
+			return std::string();
+		}
+
+		// one line per stack, weighted in microseconds
+		for (const auto &stack : s_stacks)
+			fprintf(f, "%s %llu\n", stack.first.c_str(), static_cast<unsigned long long>(stack.second * 1e3 + 0.5));
+		fclose(f);
+
+		Output("Lua profiler: wrote %s\n", path.c_str());
+		return path;
+	}
+
+	Scope::Scope(const char *name) :
+		m_active(s_running),
+		m_named(false)
+	{
+		if (!m_active) return;
+
+		if (name) {
+			s_entryPoints.push_back(name);
+			m_named = true;
+		}
+		if (s_scopeDepth++ == 0)
+			s_lastSample = Clock::now();
+	}
+
+	Scope::~Scope()
+	{
+		if (!m_active) return;
+
+		if (m_named)
+			s_entryPoints.pop_back();
+		// whatever runs before Lua is entered again isn't Lua's time
+		if (--s_scopeDepth == 0)
+			s_lastSample = Clock::now();
+	}
+
+} // namespace LuaProfiler
@@ -0,0 +1,67 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _LUAPROFILER_H
+#define _LUAPROFILER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct lua_State;
+
+/*
+ * Sampling profiler for Lua code. While running, a count hook stops the VM
+ * every few hundred instructions and credits the time since the previous
+ * sample to the Lua stack it finds: to the function and line at the top, to
+ * the module (data/modules/<name>) the stack started in, and to the C++
+ * entry point (an event handler, a timer callback) that called into Lua.
+ * Time spent outside Lua is not counted.
+ *
+ * Full stacks are kept too, and can be written out in the folded format
+ * used by flamegraph.pl and speedscope.
+ */
+namespace LuaProfiler {
+
+	enum Category {
+		CATEGORY_FUNCTION,
+		CATEGORY_LINE,
+		CATEGORY_MODULE,
+		CATEGORY_ENTRY_POINT,
+		CATEGORY_MAX
+	};
+
+	void Start(lua_State *l);
+	void Stop(lua_State *l);
+	bool IsRunning();
+	void Clear();
+
+	// total sampled time, in milliseconds
+	double GetTotalTime();
+	// the most expensive entries of a category, in milliseconds
+	std::vector<std::pair<std::string, double>> GetTop(Category category, size_t count);
+
+	// writes to the user directory, returns the path written or an empty string
+	std::string WriteFlameGraph();
+
+	// Marks a call from C++ into Lua. Time before it isn't credited to Lua,
+	// and the samples taken inside it are credited to name, if one is given,
+	// or otherwise to the enclosing scope.
+	class Scope {
+	public:
+		explicit Scope(const char *name = nullptr);
+		explicit Scope(const std::string &name) :
+			Scope(name.c_str()) {}
+		~Scope();
+
+	private:
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+		bool m_active;
+		bool m_named;
+	};
+
+} // namespace LuaProfiler
+
+#endif
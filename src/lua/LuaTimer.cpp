@@ -5,8 +5,17 @@
 #include "Game.h"
 #include "Lua.h"
 #include "LuaObject.h"
+#include "LuaProfiler.h"
 #include "LuaUtils.h"
 #include "Pi.h"
+#include <algorithm>
+
+LuaTimer::LuaTimer() :
+	m_nextId(0),
+	m_activeCounter(m_stats.GetOrCreateCounter("Active Timers", false)),
+	m_firedCounter(m_stats.GetOrCreateCounter("Timers Fired"))
+{
+}
 
 void LuaTimer::RemoveAll()
 {
@@ -14,11 +23,44 @@ void LuaTimer::RemoveAll()
 
 	lua_pushnil(l);
 	lua_setfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
+
+	m_timers.clear();
+	m_stats.CounterSet(m_activeCounter, 0);
+}
+
+void LuaTimer::Insert(lua_State *l, double at, double every)
+{
+	LUA_DEBUG_START(l);
+
+	lua_getfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
+	if (lua_isnil(l, -1)) {
+		lua_pop(l, 1);
+		lua_newtable(l);
+		lua_pushvalue(l, -1);
+		lua_setfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
+	}
+
+	const Uint32 id = ++m_nextId;
+	lua_insert(l, -2);
+	lua_rawseti(l, -2, id);
+	lua_pop(l, 1);
+
+	m_timers.push_back({ at, every, id });
+	std::push_heap(m_timers.begin(), m_timers.end());
+	m_stats.CounterSet(m_activeCounter, Uint32(m_timers.size()));
+
+	LUA_DEBUG_END(l, -1);
 }
 
 void LuaTimer::Tick()
 {
+	PROFILE_SCOPED()
 	assert(Pi::game);
+
+	const double now = Pi::game->GetTime();
+	if (m_timers.empty() || m_timers.front().at > now)
+		return;
+
 	lua_State *l = Lua::manager->GetLuaState();
 
 	LUA_DEBUG_START(l);
@@ -26,46 +68,51 @@ void LuaTimer::Tick()
 	lua_getfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
 	if (lua_isnil(l, -1)) {
 		lua_pop(l, 1);
+		m_timers.clear();
 		LUA_DEBUG_END(l, 0);
 		return;
 	}
 	assert(lua_istable(l, -1));
 
-	double now = Pi::game->GetTime();
-
-	lua_pushnil(l);
-	while (lua_next(l, -2)) {
-		assert(lua_istable(l, -1));
-
-		lua_getfield(l, -1, "at");
-		double at = lua_tonumber(l, -1);
-		lua_pop(l, 1);
+	// callbacks can add timers, but never ones that are already due
+	while (!m_timers.empty() && m_timers.front().at <= now) {
+		std::pop_heap(m_timers.begin(), m_timers.end());
+		Timer timer = m_timers.back();
+		m_timers.pop_back();
 
-		if (at <= now) {
-			lua_getfield(l, -1, "callback");
-			pi_lua_protected_call(l, 0, 1);
-			bool cancel = lua_toboolean(l, -1);
+		// a callback may have called RemoveAll, leaving stale timers behind
+		lua_rawgeti(l, -1, timer.id);
+		if (lua_isnil(l, -1)) {
 			lua_pop(l, 1);
-
-			lua_getfield(l, -1, "every");
-			if (lua_isnil(l, -1) || cancel) {
-				lua_pop(l, 1);
-
-				lua_pushvalue(l, -2);
-				lua_pushnil(l);
-				lua_settable(l, -5);
-			} else {
-				double every = lua_tonumber(l, -1);
-				lua_pop(l, 1);
-
-				pi_lua_settable(l, "at", Pi::game->GetTime() + every);
-			}
+			continue;
 		}
 
+		if (LuaProfiler::IsRunning()) {
+			// timers are told apart by where their callback was defined
+			lua_Debug ar;
+			lua_pushvalue(l, -1);
+			lua_getinfo(l, ">S", &ar);
+			LuaProfiler::Scope profilerScope(std::string("Timer ") + ar.source + ":" + std::to_string(ar.linedefined));
+			pi_lua_protected_call(l, 0, 1);
+		} else
+			pi_lua_protected_call(l, 0, 1);
+		const bool cancel = lua_toboolean(l, -1);
 		lua_pop(l, 1);
+		m_stats.CounterAdd(m_firedCounter);
+
+		if (timer.every > 0.0 && !cancel) {
+			timer.at = Pi::game->GetTime() + timer.every;
+			m_timers.push_back(timer);
+			std::push_heap(m_timers.begin(), m_timers.end());
+		} else {
+			lua_pushnil(l);
+			lua_rawseti(l, -2, timer.id);
+		}
 	}
 	lua_pop(l, 1);
 
+	m_stats.CounterSet(m_activeCounter, Uint32(m_timers.size()));
+
 	LUA_DEBUG_END(l, 0);
 }
 
@@ -105,28 +152,6 @@ void LuaTimer::Tick()
  * underlying object exists before trying to use it.
  */
 
-static void _finish_timer_create(lua_State *l)
-{
-	lua_pushstring(l, "callback");
-	lua_pushvalue(l, 3);
-	lua_settable(l, -3);
-
-	lua_getfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
-	if (lua_isnil(l, -1)) {
-		lua_pop(l, 1);
-		lua_newtable(l);
-		lua_pushvalue(l, -1);
-		lua_setfield(l, LUA_REGISTRYINDEX, "PiTimerCallbacks");
-	}
-
-	lua_insert(l, -2);
-	lua_pushinteger(l, lua_rawlen(l, -2) + 1);
-	lua_insert(l, -2);
-	lua_settable(l, -3);
-
-	lua_pop(l, 1);
-}
-
 /*
  * Method: CallAt
  *
@@ -171,14 +196,8 @@ static int l_timer_call_at(lua_State *l)
 	if (at <= Pi::game->GetTime())
 		luaL_error(l, "Specified time is in the past");
 
-	LUA_DEBUG_START(l);
-
-	lua_newtable(l);
-	pi_lua_settable(l, "at", at);
-
-	_finish_timer_create(l);
-
-	LUA_DEBUG_END(l, 0);
+	lua_pushvalue(l, 3);
+	Pi::luaTimer->Insert(l, at, 0.0);
 
 	return 0;
 }
@@ -236,15 +255,8 @@ static int l_timer_call_every(lua_State *l)
 	if (every <= 0)
 		luaL_error(l, "Specified interval must be greater than zero");
 
-	LUA_DEBUG_START(l);
-
-	lua_newtable(l);
-	pi_lua_settable(l, "every", every);
-	pi_lua_settable(l, "at", Pi::game->GetTime() + every);
-
-	_finish_timer_create(l);
-
-	LUA_DEBUG_END(l, 0);
+	lua_pushvalue(l, 3);
+	Pi::luaTimer->Insert(l, Pi::game->GetTime() + every, every);
 
 	return 0;
 }
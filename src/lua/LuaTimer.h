@@ -6,11 +6,45 @@
 
 #include "DeleteEmitter.h"
 #include "LuaManager.h"
+#include "PerfStats.h"
+#include <SDL_stdinc.h>
+#include <vector>
 
 class LuaTimer : public DeleteEmitter {
 public:
+	LuaTimer();
+
 	void Tick();
 	void RemoveAll();
+
+	// schedule the function on top of the stack (and pop it) to be called at
+	// game time 'at', then every 'every' seconds after that if every > 0
+	void Insert(lua_State *l, double at, double every);
+
+	size_t GetTimerCount() const { return m_timers.size(); }
+	Perf::Stats &GetStats() { return m_stats; }
+
+private:
+	struct Timer {
+		double at;
+		double every;
+		Uint32 id; // key of the callback in the PiTimerCallbacks registry table
+
+		// std heaps keep the greatest element on top, so order by latest first;
+		// timers due at the same time fire in the order they were created
+		bool operator<(const Timer &other) const
+		{
+			return at > other.at || (at == other.at && id > other.id);
+		}
+	};
+
+	// min-heap on fire time, so a tick only ever looks at the timers that are due
+	std::vector<Timer> m_timers;
+	Uint32 m_nextId;
+
+	Perf::Stats m_stats;
+	Perf::Stats::CounterRef m_activeCounter;
+	Perf::Stats::CounterRef m_firedCounter;
 };
 
 #endif
@@ -4,37 +4,317 @@
 #include "PropertyMap.h"
 #include "LuaSerializer.h"
 #include "LuaUtils.h"
+#include <algorithm>
+#include <unordered_map>
 
-PropertyMap::PropertyMap(LuaManager *lua)
+std::vector<PropertyMap *> PropertyMap::s_luaPending;
+std::vector<PropertyMap *> PropertyMap::s_signalPending;
+
+// function statics, ids are interned during static initialisation
+static std::unordered_map<std::string, PropertyMap::Id> &InternedIds()
+{
+	static std::unordered_map<std::string, PropertyMap::Id> ids;
+	return ids;
+}
+
+static std::vector<std::string> &InternedNames()
+{
+	static std::vector<std::string> names;
+	return names;
+}
+
+PropertyMap::Id PropertyMap::Intern(const std::string &k)
+{
+	auto &ids = InternedIds();
+	auto it = ids.find(k);
+	if (it != ids.end())
+		return it->second;
+
+	const Id id = Id(InternedNames().size());
+	InternedNames().push_back(k);
+	ids.emplace(k, id);
+	return id;
+}
+
+const std::string &PropertyMap::GetName(Id id)
+{
+	return InternedNames()[id];
+}
+
+PropertyMap::PropertyMap(LuaManager *lua) :
+	m_lua(lua->GetLuaState()),
+	m_luaPending(false),
+	m_signalPending(false)
+{
+}
+
+PropertyMap::~PropertyMap()
+{
+	if (m_luaPending)
+		s_luaPending.erase(std::find(s_luaPending.begin(), s_luaPending.end(), this));
+	if (m_signalPending)
+		s_signalPending.erase(std::find(s_signalPending.begin(), s_signalPending.end(), this));
+}
+
+PropertyMap::Entry &PropertyMap::GetEntry(Id id)
+{
+	if (id >= m_entries.size())
+		m_entries.resize(id + 1);
+	return m_entries[id];
+}
+
+void PropertyMap::MarkChanged(Id id, Entry &e)
+{
+	// nothing to update until Lua has the table
+	if (m_table.IsValid() && !e.luaDirty) {
+		e.luaDirty = true;
+		m_luaDirty.push_back(id);
+		if (!m_luaPending) {
+			m_luaPending = true;
+			s_luaPending.push_back(this);
+		}
+	}
+
+	if (!e.signalDirty && m_signals.count(id)) {
+		e.signalDirty = true;
+		m_signalDirty.push_back(id);
+		if (!m_signalPending) {
+			m_signalPending = true;
+			s_signalPending.push_back(this);
+		}
+	}
+}
+
+void PropertyMap::Set(Id id, double v)
+{
+	Entry &e = GetEntry(id);
+	if (e.type == TYPE_NUMBER && e.number == v)
+		return;
+	if (e.type == TYPE_LUA)
+		m_luaValues.erase(id);
+	e.type = TYPE_NUMBER;
+	e.number = v;
+	MarkChanged(id, e);
+}
+
+void PropertyMap::Set(Id id, bool v)
+{
+	Entry &e = GetEntry(id);
+	if (e.type == TYPE_BOOL && e.boolean == v)
+		return;
+	if (e.type == TYPE_LUA)
+		m_luaValues.erase(id);
+	e.type = TYPE_BOOL;
+	e.boolean = v;
+	MarkChanged(id, e);
+}
+
+void PropertyMap::Set(Id id, const std::string &v)
+{
+	Entry &e = GetEntry(id);
+	if (e.type == TYPE_STRING && e.string == v)
+		return;
+	if (e.type == TYPE_LUA)
+		m_luaValues.erase(id);
+	e.type = TYPE_STRING;
+	e.string = v;
+	MarkChanged(id, e);
+}
+
+void PropertyMap::SetLuaValue(Id id)
 {
-	lua_State *l = lua->GetLuaState();
-	LUA_DEBUG_START(l);
-	lua_newtable(l);
-	m_table = LuaRef(l, -1);
-	lua_pop(l, 1);
-	LUA_DEBUG_END(l, 0);
+	Entry &e = GetEntry(id);
+	if (lua_isnil(m_lua, -1)) {
+		lua_pop(m_lua, 1);
+		Unset(id);
+		return;
+	}
+
+	// Lua values are always taken as changed, tables may have been modified
+	e.type = TYPE_LUA;
+	m_luaValues[id] = LuaRef(m_lua, -1);
+	lua_pop(m_lua, 1);
+	MarkChanged(id, e);
+}
+
+void PropertyMap::Unset(Id id)
+{
+	if (id >= m_entries.size() || m_entries[id].type == TYPE_NIL)
+		return;
+
+	Entry &e = m_entries[id];
+	if (e.type == TYPE_LUA)
+		m_luaValues.erase(id);
+	e.type = TYPE_NIL;
+	e.string.clear();
+	MarkChanged(id, e);
+}
+
+void PropertyMap::Get(Id id, bool &v) const
+{
+	if (id < m_entries.size() && m_entries[id].type == TYPE_BOOL)
+		v = m_entries[id].boolean;
 }
 
-void PropertyMap::SendSignal(const std::string &k)
+void PropertyMap::Get(Id id, std::string &v) const
 {
-	std::map<std::string, sigc::signal<void, PropertyMap &, const std::string &>>::iterator i = m_signals.find(k);
-	if (i == m_signals.end())
+	if (id >= m_entries.size())
 		return;
 
-	(*i).second.emit(*this, k);
+	const Entry &e = m_entries[id];
+	if (e.type == TYPE_STRING)
+		v = e.string;
+	else if (e.type == TYPE_NUMBER) {
+		// as Lua would convert it
+		char buf[32];
+		snprintf(buf, sizeof(buf), LUA_NUMBER_FMT, e.number);
+		v = buf;
+	}
+}
+
+void PropertyMap::PushValue(Id id) const
+{
+	const Entry &e = m_entries[id];
+	switch (e.type) {
+	case TYPE_NUMBER: lua_pushnumber(m_lua, e.number); break;
+	case TYPE_BOOL: lua_pushboolean(m_lua, e.boolean); break;
+	case TYPE_STRING: lua_pushlstring(m_lua, e.string.c_str(), e.string.size()); break;
+	case TYPE_LUA: m_luaValues.at(id).PushCopyToStack(); break;
+	default: lua_pushnil(m_lua); break;
+	}
+}
+
+void PropertyMap::CreateLuaTable()
+{
+	LUA_DEBUG_START(m_lua);
+
+	lua_createtable(m_lua, 0, int(m_entries.size()));
+	for (Id id = 0; id < m_entries.size(); id++) {
+		if (m_entries[id].type == TYPE_NIL)
+			continue;
+		const std::string &name = GetName(id);
+		lua_pushlstring(m_lua, name.c_str(), name.size());
+		PushValue(id);
+		lua_rawset(m_lua, -3);
+	}
+	m_table = LuaRef(m_lua, -1);
+	lua_pop(m_lua, 1);
+
+	LUA_DEBUG_END(m_lua, 0);
+}
+
+void PropertyMap::SyncLuaTable()
+{
+	if (m_luaDirty.empty())
+		return;
+
+	LUA_DEBUG_START(m_lua);
+
+	m_table.PushCopyToStack();
+	for (Id id : m_luaDirty) {
+		m_entries[id].luaDirty = false;
+		const std::string &name = GetName(id);
+		lua_pushlstring(m_lua, name.c_str(), name.size());
+		PushValue(id);
+		lua_rawset(m_lua, -3);
+	}
+	lua_pop(m_lua, 1);
+	m_luaDirty.clear();
+
+	LUA_DEBUG_END(m_lua, 0);
+}
+
+void PropertyMap::FlushLuaTables()
+{
+	PROFILE_SCOPED()
+	for (PropertyMap *map : s_luaPending) {
+		map->SyncLuaTable();
+		map->m_luaPending = false;
+	}
+	s_luaPending.clear();
+}
+
+void PropertyMap::EmitPendingSignals()
+{
+	PROFILE_SCOPED()
+	// handlers may set more properties, which are picked up as well
+	while (!s_signalPending.empty()) {
+		PropertyMap *map = s_signalPending.back();
+		s_signalPending.pop_back();
+		map->m_signalPending = false;
+
+		std::vector<Id> dirty;
+		dirty.swap(map->m_signalDirty);
+		for (Id id : dirty) {
+			map->m_entries[id].signalDirty = false;
+			auto it = map->m_signals.find(id);
+			if (it != map->m_signals.end())
+				it->second.emit(*map, GetName(id));
+		}
+	}
 }
 
 void PropertyMap::PushLuaTable()
 {
+	if (!m_table.IsValid())
+		CreateLuaTable();
+	else
+		SyncLuaTable();
 	m_table.PushCopyToStack();
 }
 
 void PropertyMap::SaveToJson(Json &jsonObj)
 {
+	if (!m_table.IsValid())
+		CreateLuaTable();
+	else
+		SyncLuaTable();
 	m_table.SaveToJson(jsonObj);
 }
 
 void PropertyMap::LoadFromJson(const Json &jsonObj)
 {
+	// the loaded table replaces anything set so far
+	m_entries.clear();
+	m_luaValues.clear();
+	m_luaDirty.clear();
+	m_signalDirty.clear();
+
 	m_table.LoadFromJson(jsonObj);
+	if (!m_table.IsValid())
+		return;
+
+	// take the values back out of it
+	LUA_DEBUG_START(m_lua);
+
+	m_table.PushCopyToStack();
+	const int table = lua_gettop(m_lua);
+	lua_pushnil(m_lua);
+	while (lua_next(m_lua, table)) {
+		if (lua_type(m_lua, -2) == LUA_TSTRING) {
+			Entry &e = GetEntry(Intern(lua_tostring(m_lua, -2)));
+			switch (lua_type(m_lua, -1)) {
+			case LUA_TNUMBER:
+				e.type = TYPE_NUMBER;
+				e.number = lua_tonumber(m_lua, -1);
+				break;
+			case LUA_TBOOLEAN:
+				e.type = TYPE_BOOL;
+				e.boolean = lua_toboolean(m_lua, -1);
+				break;
+			case LUA_TSTRING:
+				e.type = TYPE_STRING;
+				e.string = lua_tostring(m_lua, -1);
+				break;
+			default:
+				e.type = TYPE_LUA;
+				m_luaValues[Intern(lua_tostring(m_lua, -2))] = LuaRef(m_lua, -1);
+				break;
+			}
+		}
+		lua_pop(m_lua, 1);
+	}
+	lua_pop(m_lua, 1);
+
+	LUA_DEBUG_END(m_lua, 0);
 }
@@ -7,39 +7,164 @@
 #include "LuaManager.h"
 #include "LuaRef.h"
 #include "LuaTable.h"
+#include <map>
+#include <type_traits>
 
+/*
+ * Named values on an object, shared between C++ and Lua. The values live on
+ * the C++ side, indexed by interned property ids, and Lua sees them through a
+ * table that is only created when the object is first pushed to Lua.
+ *
+ * Changes are coalesced: the Lua tables of all changed maps are brought up
+ * to date before Lua can next look at them (see SyncLuaTables), and change
+ * signals go out once per frame (see EmitPendingSignals), however many times
+ * a property was set in between.
+ */
 class PropertyMap {
 public:
+	using Id = Uint32;
+
+	// the same name always gives the same id
+	static Id Intern(const std::string &k);
+	static const std::string &GetName(Id id);
+
 	PropertyMap(LuaManager *lua);
+	~PropertyMap();
 
 	template <class Value>
 	void Set(const std::string &k, const Value &v)
 	{
-		ScopedTable(m_table).Set(k, v);
-		SendSignal(k);
+		Set(Intern(k), v);
 	}
 
+	void Set(Id id, double v);
+	void Set(Id id, bool v);
+	void Set(Id id, const std::string &v);
+	void Set(Id id, const char *v) { Set(id, std::string(v)); }
+
+	template <class Value>
+	typename std::enable_if<std::is_arithmetic<Value>::value>::type Set(Id id, Value v)
+	{
+		Set(id, double(v));
+	}
+
+	// anything else is kept as a Lua value
+	template <class Value>
+	typename std::enable_if<!std::is_arithmetic<Value>::value>::type Set(Id id, const Value &v)
+	{
+		LUA_DEBUG_START(m_lua);
+		pi_lua_generic_push(m_lua, v);
+		SetLuaValue(id);
+		LUA_DEBUG_END(m_lua, 0);
+	}
+
+	void Unset(const std::string &k) { Unset(Intern(k)); }
+	void Unset(Id id);
+
+	// v is left alone if the property isn't set or has another type
 	template <class Value>
 	void Get(const std::string &k, Value &v) const
 	{
-		v = ScopedTable(m_table).Get<Value>(k, v);
+		Get(Intern(k), v);
+	}
+
+	void Get(Id id, bool &v) const;
+	void Get(Id id, std::string &v) const;
+
+	template <class Value>
+	typename std::enable_if<std::is_arithmetic<Value>::value>::type Get(Id id, Value &v) const
+	{
+		if (id < m_entries.size() && m_entries[id].type == TYPE_NUMBER)
+			v = Value(m_entries[id].number);
 	}
 
+	template <class Value>
+	typename std::enable_if<!std::is_arithmetic<Value>::value>::type Get(Id id, Value &v) const
+	{
+		if (id >= m_entries.size() || m_entries[id].type == TYPE_NIL)
+			return;
+		LUA_DEBUG_START(m_lua);
+		PushValue(id);
+		pi_lua_generic_pull(m_lua, -1, v);
+		lua_pop(m_lua, 1);
+		LUA_DEBUG_END(m_lua, 0);
+	}
+
+	// the table Lua sees, up to date
 	void PushLuaTable();
 
 	sigc::connection Connect(const std::string &k, const sigc::slot<void, PropertyMap &, const std::string &> &fn)
 	{
-		return m_signals[k].connect(fn);
+		return m_signals[Intern(k)].connect(fn);
 	}
 
 	void SaveToJson(Json &jsonObj);
 	void LoadFromJson(const Json &jsonObj);
 
+	// writes pending changes into the Lua tables. must be called before
+	// Lua can read properties; this is done on the way into Lua and in the
+	// metamethods that look properties up
+	static void SyncLuaTables()
+	{
+		if (!s_luaPending.empty())
+			FlushLuaTables();
+	}
+
+	// calls the change signals of everything set since the last call
+	static void EmitPendingSignals();
+
 private:
+	PropertyMap(const PropertyMap &) = delete;
+	PropertyMap &operator=(const PropertyMap &) = delete;
+
+	enum Type : Uint8 {
+		TYPE_NIL,
+		TYPE_NUMBER,
+		TYPE_BOOL,
+		TYPE_STRING,
+		TYPE_LUA // in m_luaValues
+	};
+
+	struct Entry {
+		Entry() :
+			type(TYPE_NIL),
+			luaDirty(false),
+			signalDirty(false),
+			boolean(false),
+			number(0.0) {}
+		Type type;
+		bool luaDirty;
+		bool signalDirty;
+		bool boolean;
+		double number;
+		std::string string;
+	};
+
+	Entry &GetEntry(Id id);
+	void MarkChanged(Id id, Entry &e);
+	// takes the value from the top of the stack
+	void SetLuaValue(Id id);
+	void PushValue(Id id) const;
+
+	void CreateLuaTable();
+	void SyncLuaTable();
+	static void FlushLuaTables();
+
+	lua_State *m_lua;
 	LuaRef m_table;
 
-	void SendSignal(const std::string &k);
-	std::map<std::string, sigc::signal<void, PropertyMap &, const std::string &>> m_signals;
+	std::vector<Entry> m_entries;
+	std::map<Id, LuaRef> m_luaValues;
+
+	std::vector<Id> m_luaDirty;
+	std::vector<Id> m_signalDirty;
+	bool m_luaPending;
+	bool m_signalPending;
+
+	std::map<Id, sigc::signal<void, PropertyMap &, const std::string &>> m_signals;
+
+	static std::vector<PropertyMap *> s_luaPending;
+	static std::vector<PropertyMap *> s_signalPending;
 };
 
 #endif
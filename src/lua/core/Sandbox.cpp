@@ -2,6 +2,8 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "CoreFwdDecl.h"
+#include "../LuaProfiler.h"
+#include "../PropertyMap.h"
 #include "FileSystem.h"
 #include "libs.h"
 
@@ -158,6 +160,8 @@ int pi_lua_panic(lua_State *L)
 
 void pi_lua_protected_call(lua_State *L, int nargs, int nresults)
 {
+	LuaProfiler::Scope profilerScope;
+	PropertyMap::SyncLuaTables();
 	int handleridx = lua_gettop(L) - nargs;
 	lua_pushcfunction(L, &l_handle_error);
 	lua_insert(L, handleridx);
@@ -0,0 +1,204 @@
+// Copyright © 2008-2020 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "FileSourcePack.h"
+#include "FileSystem.h"
+#include "core/LZ4Format.h"
+#include "utils.h"
+#include <SDL.h>
+#include <SDL_endian.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace FileSystem;
+
+// skip the same files 'make install' leaves out of the data directory
+static bool ShouldPack(const FileInfo &info)
+{
+	const std::string &path = info.GetPath();
+	const std::string name = info.GetName();
+
+	if (info.IsSpecial() || name == ".gitignore" || name == "Makefile.am" || starts_with(name, "listdata.") || ends_with_ci(path, ".pak"))
+		return false;
+
+	// only the compiled and texture parts of models are shipped
+	if (info.IsFile() && starts_with(path, "models/"))
+		return ends_with_ci(path, ".sgm") || ends_with_ci(path, ".dds") || ends_with_ci(path, ".png");
+
+	return true;
+}
+
+static bool WriteIndex(FILE *out, const Pack::Header &header, const std::vector<Pack::Entry> &entries,
+	const std::vector<Uint32> &buckets, const std::string &names)
+{
+	Pack::Header h = header;
+	h.version = SDL_SwapLE32(h.version);
+	h.numEntries = SDL_SwapLE32(h.numEntries);
+	h.numBuckets = SDL_SwapLE32(h.numBuckets);
+	h.namesSize = SDL_SwapLE32(h.namesSize);
+
+	std::vector<Pack::Entry> e(entries);
+	for (Pack::Entry &entry : e) {
+		entry.hash = SDL_SwapLE64(entry.hash);
+		entry.offset = SDL_SwapLE64(entry.offset);
+		entry.size = SDL_SwapLE64(entry.size);
+		entry.packedSize = SDL_SwapLE64(entry.packedSize);
+		entry.nameOffset = SDL_SwapLE32(entry.nameOffset);
+	}
+	std::vector<Uint32> b(buckets);
+	for (Uint32 &bucket : b)
+		bucket = SDL_SwapLE32(bucket);
+
+	return fseek(out, 0, SEEK_SET) == 0 &&
+		fwrite(&h, sizeof(h), 1, out) == 1 &&
+		fwrite(e.data(), sizeof(Pack::Entry), e.size(), out) == e.size() &&
+		fwrite(b.data(), sizeof(Uint32), b.size(), out) == b.size() &&
+		fwrite(names.data(), 1, names.size(), out) == names.size();
+}
+
+extern "C" int main(int argc, char **argv)
+{
+	bool useLZ4 = false;
+	std::vector<std::string> args;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-lz4") == 0)
+			useLZ4 = true;
+		else
+			args.push_back(argv[i]);
+	}
+
+	if (args.empty() || args.size() > 2) {
+		printf(
+			"packdata - Build a packed data archive from a data directory.\n"
+			"The source defaults to the pioneer data folder.\n"
+			"USAGE: packdata [-lz4] <output> [source]\n");
+		return 1;
+	}
+
+	const std::string outname = args[0];
+	FileSourceFS source(args.size() > 1 ? args[1] : GetDataDir());
+
+	// walk the tree breadth-first, so that each directory's children end up
+	// contiguous in the entry table (ReadDirectory returns them sorted)
+	std::vector<FileInfo> infos;
+	std::vector<Pack::Entry> entries;
+	std::string names;
+
+	auto addEntry = [&](const FileInfo &info) {
+		Pack::Entry e;
+		memset(&e, 0, sizeof(e));
+		e.hash = Pack::HashPath(info.GetPath());
+		e.type = info.IsDir() ? Pack::ENTRY_DIR : Pack::ENTRY_FILE;
+		e.nameOffset = Uint32(names.size());
+		names.append(info.GetPath());
+		names.push_back('\0');
+		entries.push_back(e);
+		infos.push_back(info);
+	};
+
+	const FileInfo root = source.Lookup("");
+	if (!root.IsDir()) {
+		printf("Source directory %s could not be found.\n", source.GetRoot().c_str());
+		return 1;
+	}
+	addEntry(root);
+
+	for (size_t i = 0; i < entries.size(); i++) {
+		if (entries[i].type != Pack::ENTRY_DIR) continue;
+
+		std::vector<FileInfo> children;
+		source.ReadDirectory(infos[i].GetPath(), children);
+
+		entries[i].offset = entries.size();
+		for (const FileInfo &child : children) {
+			if (!ShouldPack(child)) continue;
+			addEntry(child);
+		}
+		entries[i].size = entries.size() - entries[i].offset;
+	}
+
+	Pack::Header header;
+	memcpy(header.magic, Pack::MAGIC, sizeof(header.magic));
+	header.version = Pack::VERSION;
+	header.numEntries = Uint32(entries.size());
+	header.numBuckets = Pack::BucketCount(header.numEntries);
+	header.namesSize = Uint32(names.size());
+	header.reserved = 0;
+
+	std::vector<Uint32> buckets(header.numBuckets, Pack::EMPTY_BUCKET);
+	const Uint32 mask = header.numBuckets - 1;
+	for (Uint32 i = 0; i < header.numEntries; i++) {
+		Uint32 slot = Uint32(entries[i].hash) & mask;
+		while (buckets[slot] != Pack::EMPTY_BUCKET)
+			slot = (slot + 1) & mask;
+		buckets[slot] = i;
+	}
+
+	FILE *out = fopen(outname.c_str(), "wb");
+	if (!out) {
+		printf("Could not open output file %s.\n", outname.c_str());
+		return 1;
+	}
+
+	// the file offsets aren't known until the data has been written,
+	// so write the index once to reserve its space and again at the end
+	if (!WriteIndex(out, header, entries, buckets, names)) {
+		printf("Could not write to output file %s.\n", outname.c_str());
+		fclose(out);
+		return 1;
+	}
+
+	Uint64 offset = sizeof(Pack::Header) + entries.size() * sizeof(Pack::Entry) + buckets.size() * sizeof(Uint32) + names.size();
+	Uint64 totalSize = 0;
+	size_t numFiles = 0;
+
+	for (size_t i = 0; i < entries.size(); i++) {
+		Pack::Entry &e = entries[i];
+		if (e.type != Pack::ENTRY_FILE) continue;
+
+		RefCountedPtr<FileData> data = source.ReadFile(infos[i].GetPath());
+		if (!data) {
+			printf("Could not read %s.\n", infos[i].GetPath().c_str());
+			fclose(out);
+			return 1;
+		}
+
+		const lz4::string_view plain(data->GetData(), data->GetSize());
+		std::string packed;
+		if (useLZ4 && plain.size() > 0) {
+			packed = lz4::CompressLZ4(plain, 0);
+			// not worth a decompression on every read
+			if (packed.size() > plain.size() - plain.size() / 8)
+				packed.clear();
+		}
+
+		const bool compressed = !packed.empty();
+		const char *bytes = compressed ? packed.data() : plain.data();
+		e.offset = offset;
+		e.size = plain.size();
+		e.packedSize = compressed ? packed.size() : plain.size();
+		e.compression = compressed ? Pack::COMPRESS_LZ4 : Pack::COMPRESS_NONE;
+
+		if (fwrite(bytes, 1, size_t(e.packedSize), out) != e.packedSize) {
+			printf("Could not write to output file %s.\n", outname.c_str());
+			fclose(out);
+			return 1;
+		}
+
+		offset += e.packedSize;
+		totalSize += e.size;
+		numFiles++;
+	}
+
+	if (!WriteIndex(out, header, entries, buckets, names)) {
+		printf("Could not write to output file %s.\n", outname.c_str());
+		fclose(out);
+		return 1;
+	}
+	fclose(out);
+
+	printf("Packed %zu files (%llu bytes) into %s (%llu bytes).\n", numFiles,
+		static_cast<unsigned long long>(totalSize), outname.c_str(), static_cast<unsigned long long>(offset));
+
+	return 0;
+}
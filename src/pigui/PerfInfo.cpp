@@ -7,12 +7,16 @@
 #include "Pi.h"
 #include "Player.h"
 #include "Space.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/Renderer.h"
 #include "graphics/Stats.h"
 #include "graphics/Texture.h"
 #include "lua/Lua.h"
+#include "lua/LuaEvent.h"
 #include "lua/LuaManager.h"
 #include "lua/LuaPiGui.h"
+#include "lua/LuaProfiler.h"
+#include "lua/LuaTimer.h"
 #include "scenegraph/Model.h"
 #include "text/TextureFont.h"
 
@@ -200,7 +204,8 @@ void PerfInfo::DrawPerfWindow()
 
 		if (process_mem.currentMemSize)
 			ImGui::Text("%.1f MB process memory usage (%.1f MB peak)", (process_mem.currentMemSize * 1e-3), (process_mem.peakMemSize * 1e-3));
-		ImGui::Text("%.3f MB Lua memory usage", double(lua_mem) / scale_MB);
+		ImGui::Text("%.3f MB Lua memory usage (%.3f MB peak)", double(lua_mem) / scale_MB,
+			double(Lua::manager->GetAllocator().GetHighWaterMark()) / scale_MB);
 		ImGui::Spacing();
 	}
 
@@ -215,6 +220,11 @@ void PerfInfo::DrawPerfWindow()
 			ImGui::EndTabItem();
 		}
 
+		if (ImGui::BeginTabItem("Lua Profiler")) {
+			DrawLuaProfiler();
+			ImGui::EndTabItem();
+		}
+
 		if (Pi::game) {
 			if (Pi::player->GetFlightState() != Ship::HYPERSPACE && ImGui::BeginTabItem("WorldView")) {
 				DrawWorldViewStats();
@@ -227,6 +237,35 @@ void PerfInfo::DrawPerfWindow()
 				DrawStatList(stats.GetFrameStats());
 				ImGui::EndTabItem();
 			}
+
+			if (ImGui::BeginTabItem("Lua Timers")) {
+				auto &stats = Pi::luaTimer->GetStats();
+				stats.FlushFrame();
+				DrawStatList(stats.GetFrameStats());
+				ImGui::EndTabItem();
+			}
+
+			if (ImGui::BeginTabItem("Lua Events")) {
+				auto &stats = LuaEvent::GetStats();
+				stats.FlushFrame();
+				DrawStatList(stats.GetFrameStats());
+				ImGui::EndTabItem();
+			}
+
+			if (ImGui::BeginTabItem("Lua Memory")) {
+				LuaAllocator &allocator = Lua::manager->GetAllocator();
+				allocator.UpdateStats();
+				auto &stats = allocator.GetStats();
+				stats.FlushFrame();
+				auto &gcStats = Lua::manager->GetGCStats();
+				gcStats.FlushFrame();
+
+				// the stat list fills the rest of the tab, so draw both as one
+				Perf::Stats::FrameInfo info = stats.GetFrameStats();
+				info.insert(gcStats.GetFrameStats().begin(), gcStats.GetFrameStats().end());
+				DrawStatList(info);
+				ImGui::EndTabItem();
+			}
 		}
 
 		PiGUI::RunHandler(Pi::GetFrameTime(), "debug-tabs");
@@ -246,6 +285,9 @@ void PerfInfo::DrawRendererStats()
 	const Uint32 numBuffersInUse = stats.m_stats[Graphics::Stats::STAT_BUFFER_INUSE];
 	const Uint32 numDrawTris = stats.m_stats[Graphics::Stats::STAT_DRAWTRIS];
 	const Uint32 numDrawPointSprites = stats.m_stats[Graphics::Stats::STAT_DRAWPOINTSPRITES];
+	const Uint32 numProgramChanges = stats.m_stats[Graphics::Stats::STAT_PROGRAM_CHANGES];
+	const Uint32 numMaterialChanges = stats.m_stats[Graphics::Stats::STAT_MATERIAL_CHANGES];
+	const Uint32 numRenderStateChanges = stats.m_stats[Graphics::Stats::STAT_RENDERSTATE_CHANGES];
 	const Uint32 numDrawBuildings = stats.m_stats[Graphics::Stats::STAT_BUILDINGS];
 	const Uint32 numDrawCities = stats.m_stats[Graphics::Stats::STAT_CITIES];
 	const Uint32 numDrawGroundStations = stats.m_stats[Graphics::Stats::STAT_GROUNDSTATIONS];
@@ -271,6 +313,13 @@ void PerfInfo::DrawRendererStats()
 		Pi::statSceneTris, Pi::statSceneTris * framesThisSecond * 1e-6, Pi::statNumPatches, Text::TextureFont::GetGlyphCount());
 	ImGui::Text("%u draw calls (%u tris, %u point sprites, %u billboards)",
 		numDrawCalls, numDrawTris, numDrawPointSprites, numDrawBillBoards);
+	ImGui::Text("%u program, %u material, %u render state changes",
+		numProgramChanges, numMaterialChanges, numRenderStateChanges);
+
+	Graphics::RenderQueue &renderQueue = Pi::renderer->GetRenderQueue();
+	bool sortDraws = renderQueue.IsEnabled();
+	if (ImGui::Checkbox("Sort model draw calls", &sortDraws))
+		renderQueue.SetEnabled(sortDraws);
 	ImGui::Text("%u Buildings, %u Cities, %u Gd.Stations, %u Sp.Stations",
 		numDrawBuildings, numDrawCities, numDrawGroundStations, numDrawSpaceStations);
 	ImGui::Text("%u Atmospheres, %u Planets, %u Gas Giants, %u Stars, %u Ships",
@@ -361,6 +410,54 @@ void PerfInfo::DrawImGuiStats()
 	ImGui::Text("%d current allocations", io.MetricsActiveAllocations);
 }
 
+void PerfInfo::DrawLuaProfiler()
+{
+	lua_State *l = Lua::manager->GetLuaState();
+	if (LuaProfiler::IsRunning()) {
+		if (ImGui::Button("Stop"))
+			LuaProfiler::Stop(l);
+	} else if (ImGui::Button("Start"))
+		LuaProfiler::Start(l);
+
+	ImGui::SameLine();
+	if (ImGui::Button("Clear"))
+		LuaProfiler::Clear();
+
+	ImGui::SameLine();
+	if (ImGui::Button("Write Flame Graph"))
+		LuaProfiler::WriteFlameGraph();
+
+	const double total = LuaProfiler::GetTotalTime();
+	ImGui::Text("%.1f ms sampled", total);
+	if (total <= 0.0)
+		return;
+
+	static const std::pair<LuaProfiler::Category, const char *> categories[] = {
+		{ LuaProfiler::CATEGORY_MODULE, "Modules" },
+		{ LuaProfiler::CATEGORY_ENTRY_POINT, "Entry Points" },
+		{ LuaProfiler::CATEGORY_FUNCTION, "Functions" },
+		{ LuaProfiler::CATEGORY_LINE, "Lines" }
+	};
+
+	ImGui::BeginChild("LuaProfile");
+	for (const auto &category : categories) {
+		if (!ImGui::CollapsingHeader(category.second, ImGuiTreeNodeFlags_DefaultOpen))
+			continue;
+
+		ImGui::Columns(3, category.second);
+		for (const auto &entry : LuaProfiler::GetTop(category.first, 20)) {
+			ImGui::TextUnformatted(entry.first.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.2f ms", entry.second);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f%%", 100.0 * entry.second / total);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns();
+	}
+	ImGui::EndChild();
+}
+
 void PerfInfo::DrawStatList(const Perf::Stats::FrameInfo &fi)
 {
 	ImGui::BeginChild("FrameInfo");
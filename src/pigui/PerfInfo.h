@@ -39,6 +39,7 @@ namespace PiGUI {
 		void DrawRendererStats();
 		void DrawWorldViewStats();
 		void DrawImGuiStats();
+		void DrawLuaProfiler();
 		void DrawStatList(const Perf::Stats::FrameInfo &fi);
 
 		static const int NUM_FRAMES = 60;
@@ -84,11 +84,19 @@ ImTextureID PiGui::RenderSVG(Graphics::Renderer *renderer, std::string svgFilena
 	img = static_cast<unsigned char *>(malloc(W * H * 4));
 	memset(img, 0, W * H * 4);
 	{
-		PROFILE_SCOPED_DESC("nsvgParseFromFile")
-		image = nsvgParseFromFile(svgFilename.c_str(), "px", 96.0f);
-		if (image == NULL) {
+		PROFILE_SCOPED_DESC("nsvgParse")
+		// svgFilename is a path in the game data. nanosvg parses in place
+		// and needs the text null terminated, so it gets its own copy
+		RefCountedPtr<FileSystem::FileData> fd = FileSystem::gameDataFiles.ReadFile(svgFilename);
+		if (!fd) {
 			Error("Could not open SVG image.\n");
 		}
+		std::vector<char> svgText(fd->GetData(), fd->GetData() + fd->GetSize());
+		svgText.push_back('\0');
+		image = nsvgParse(svgText.data(), "px", 96.0f);
+		if (image == NULL) {
+			Error("Could not parse SVG image.\n");
+		}
 	}
 	w = static_cast<int>(image->width);
 
@@ -235,7 +243,8 @@ void Instance::RefreshFontsTexture()
 	PROFILE_SCOPED()
 	// TODO: fix this, do the right thing, don't just re-create *everything* :)
 	ImGui::GetIO().Fonts->Build();
-	ImGui_ImplOpenGL3_CreateDeviceObjects();
+	if (m_renderer->GetRendererType() == Graphics::RENDERER_OPENGL_3x)
+		ImGui_ImplOpenGL3_CreateDeviceObjects();
 }
 
 void PiDefaultStyle(ImGuiStyle &style)
@@ -253,16 +262,17 @@ void Instance::Init(Graphics::Renderer *renderer)
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
 
-	// TODO: FIXME before upgrading! The sdl_gl_context parameter is currently
-	// unused, but that is slated to change very soon.
-	// We will need to fill this with a valid pointer to the OpenGL context.
-	ImGui_ImplSDL2_InitForOpenGL(m_renderer->GetSDLWindow(), NULL);
 	switch (m_renderer->GetRendererType()) {
 	default:
 	case Graphics::RENDERER_DUMMY:
-		Error("RENDERER_DUMMY is not a valid renderer, aborting.");
-		return;
+		// headless, there's no window to take input from or draw to,
+		// frames are built but never rendered
+		break;
 	case Graphics::RENDERER_OPENGL_3x:
+		// TODO: FIXME before upgrading! The sdl_gl_context parameter is currently
+		// unused, but that is slated to change very soon.
+		// We will need to fill this with a valid pointer to the OpenGL context.
+		ImGui_ImplSDL2_InitForOpenGL(m_renderer->GetSDLWindow(), NULL);
 #ifdef __APPLE__
 		ImGui_ImplOpenGL3_Init("#version 140");
 #else
@@ -299,14 +309,20 @@ void Instance::NewFrame()
 
 	switch (m_renderer->GetRendererType()) {
 	default:
-	case Graphics::RENDERER_DUMMY:
-		Error("RENDERER_DUMMY is not a valid renderer, aborting.");
-		return;
+	case Graphics::RENDERER_DUMMY: {
+		// stand in for the platform backend
+		ImGuiIO &io = ImGui::GetIO();
+		io.DisplaySize = ImVec2(float(Graphics::GetScreenWidth()), float(Graphics::GetScreenHeight()));
+		io.DeltaTime = 1.0f / 60.0f;
+		if (!io.Fonts->IsBuilt())
+			io.Fonts->Build();
+		break;
+	}
 	case Graphics::RENDERER_OPENGL_3x:
 		ImGui_ImplOpenGL3_NewFrame();
+		ImGui_ImplSDL2_NewFrame(m_renderer->GetSDLWindow());
 		break;
 	}
-	ImGui_ImplSDL2_NewFrame(m_renderer->GetSDLWindow());
 	ImGui::NewFrame();
 
 	m_renderer->CheckRenderErrors(__FUNCTION__, __LINE__);
@@ -377,7 +393,7 @@ void Instance::BakeFont(PiFont &font)
 		ImFontConfig config;
 		config.MergeMode = true;
 		float size = font.pixelsize() * face.sizefactor();
-		const std::string path = FileSystem::JoinPath(FileSystem::JoinPath(FileSystem::GetDataDir(), "fonts"), face.ttfname());
+		const std::string path = "fonts/" + face.ttfname();
 		//		Output("- baking face %s at size %f\n", path.c_str(), size);
 		face.sortUsedRanges();
 		// note that if there are no ranges at all in the face, it is ignored
@@ -400,7 +416,17 @@ void Instance::BakeFont(PiFont &font)
 				gb.AddRanges(gr);
 			}
 			gb.BuildRanges(&face.m_imgui_ranges);
-			ImFont *f = io.Fonts->AddFontFromFileTTF(path.c_str(), size, imfont == nullptr ? nullptr : &config, face.m_imgui_ranges.Data);
+
+			// read through the game data so that packed and overridden fonts
+			// work; the atlas frees the copy it is given with ImGui::MemFree
+			RefCountedPtr<FileSystem::FileData> fd = FileSystem::gameDataFiles.ReadFile(path);
+			if (!fd) {
+				Output("Terrible error! Couldn't load '%s'.\n", path.c_str());
+				abort();
+			}
+			void *fontData = ImGui::MemAlloc(fd->GetSize());
+			memcpy(fontData, fd->GetData(), fd->GetSize());
+			ImFont *f = io.Fonts->AddFontFromMemoryTTF(fontData, int(fd->GetSize()), size, imfont == nullptr ? nullptr : &config, face.m_imgui_ranges.Data);
 			assert(f);
 			if (imfont != nullptr)
 				assert(f == imfont);
@@ -453,13 +479,13 @@ void Instance::Uninit()
 	switch (m_renderer->GetRendererType()) {
 	default:
 	case Graphics::RENDERER_DUMMY:
-		return;
+		break;
 	case Graphics::RENDERER_OPENGL_3x:
 		ImGui_ImplOpenGL3_Shutdown();
+		ImGui_ImplSDL2_Shutdown();
 		break;
 	}
 
-	ImGui_ImplSDL2_Shutdown();
 	ImGui::DestroyContext();
 }
 
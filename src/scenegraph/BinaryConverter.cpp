@@ -91,7 +91,7 @@ void BinaryConverter::Save(const std::string &filename, const std::string &savep
 	PROFILE_SCOPED()
 	printf("Saving file (%s)\n", filename.c_str());
 	FILE *f = nullptr;
-	FileSystem::FileSourceFS newFS(FileSystem::GetDataDir());
+	FileSystem::FileSourceFS newFS(FileSystem::GetDataWriteDir());
 	if (!bInPlace) {
 		if (!FileSystem::userFiles.MakeDirectory(SAVE_TARGET_DIR))
 			throw CouldNotOpenFileException();
@@ -111,6 +111,10 @@ void BinaryConverter::Save(const std::string &filename, const std::string &savep
 		printf("Save file (%s)\n", FileSystem::JoinPathBelow(SAVE_TARGET_DIR, savepath + SGM_EXTENSION).c_str());
 		if (!f) throw CouldNotOpenFileException();
 	} else {
+		// the write dir is not the data dir for packed data, see GetDataWriteDir
+		const size_t dirEnd = savepath.rfind('/');
+		if (dirEnd != std::string::npos)
+			newFS.MakeDirectory(savepath.substr(0, dirEnd));
 		f = newFS.OpenWriteStream(savepath + SGM_EXTENSION);
 		if (!f) throw CouldNotOpenFileException();
 	}
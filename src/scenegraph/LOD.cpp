@@ -78,10 +78,10 @@ namespace SceneGraph {
 			}
 
 			// seperate out the transformations
-			for (auto mt : trans) {
+			for (const matrix4x4f &mt : trans) {
 				//figure out approximate pixel size of object's bounding radius
 				//on screen and pick a child to render
-				const vector3f cameraPos(-mt[12], -mt[13], -mt[14]);
+				const vector3f cameraPos = rd->instanceBase * vector3f(mt[12], mt[13], mt[14]);
 				//fov is vertical, so using screen height
 				const float pixrad = Graphics::GetScreenHeight() * rd->boundingRadius / (cameraPos.Length() * Graphics::GetFovFactor());
 				unsigned int lod = m_children.size() - 1;
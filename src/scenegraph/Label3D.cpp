@@ -3,6 +3,7 @@
 
 #include "Label3D.h"
 #include "NodeVisitor.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/Renderer.h"
 #include "graphics/RenderState.h"
 #include "graphics/VertexArray.h"
@@ -78,9 +79,8 @@ namespace SceneGraph {
 	{
 		PROFILE_SCOPED()
 		if (m_vbuffer.get()) {
-			Graphics::Renderer *r = GetRenderer();
-			r->SetTransform(trans);
-			r->DrawBuffer(m_vbuffer.get(), m_renderState, m_material.Get());
+			Graphics::RenderQueue &queue = GetRenderer()->GetRenderQueue();
+			queue.DrawBuffer(trans, m_vbuffer.get(), m_renderState, m_material.Get());
 		}
 	}
 
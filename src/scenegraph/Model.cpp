@@ -10,6 +10,7 @@
 #include "NodeCopyCache.h"
 #include "StringF.h"
 #include "Thruster.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/RenderState.h"
 #include "graphics/Renderer.h"
 #include "graphics/TextureBuilder.h"
@@ -135,6 +136,11 @@ namespace SceneGraph {
 		if (m_debugFlags & DEBUG_WIREFRAME)
 			m_renderer->SetWireFrameMode(true);
 
+		//queue the draws of the whole model, submodels included, and submit
+		//them sorted. Materials are patched above for each model, so the
+		//queue can't be kept open across models
+		Graphics::RenderQueue &queue = m_renderer->GetRenderQueue();
+		queue.Begin();
 		if (params.nodemask & MASK_IGNORE) {
 			m_root->Render(trans, &params);
 		} else {
@@ -143,6 +149,7 @@ namespace SceneGraph {
 			params.nodemask = NODE_TRANSPARENT;
 			m_root->Render(trans, &params);
 		}
+		queue.End();
 
 		if (!m_debugFlags)
 			return;
@@ -172,6 +179,11 @@ namespace SceneGraph {
 	}
 
 	void Model::Render(const std::vector<matrix4x4f> &trans, const RenderData *rd)
+	{
+		Render((rd != 0) ? rd->instanceBase : m_renderData.instanceBase, trans, rd);
+	}
+
+	void Model::Render(const matrix4x4f &base, const std::vector<matrix4x4f> &trans, const RenderData *rd)
 	{
 		PROFILE_SCOPED();
 
@@ -196,6 +208,7 @@ namespace SceneGraph {
 		//using the entire model bounding radius for all nodes at the moment.
 		//BR could also be a property of Node.
 		params.boundingRadius = GetDrawClipRadius();
+		params.instanceBase = base;
 
 		//render in two passes, if this is the top-level model
 		if (m_debugFlags & DEBUG_WIREFRAME)
@@ -209,6 +222,9 @@ namespace SceneGraph {
 			params.nodemask = NODE_TRANSPARENT;
 			m_root->Render(trans, &params);
 		}
+
+		if (m_debugFlags & DEBUG_WIREFRAME)
+			m_renderer->SetWireFrameMode(false);
 	}
 
 	void Model::CreateAabbVB()
@@ -109,6 +109,9 @@ namespace SceneGraph {
 
 		void Render(const matrix4x4f &trans, const RenderData *rd = 0); //ModelNode can override RD
 		void Render(const std::vector<matrix4x4f> &trans, const RenderData *rd = 0); //ModelNode can override RD
+		// instanced, with each transform relative to base. Keeping the instances in a local
+		// space lets the caller upload them once and only change base from frame to frame
+		void Render(const matrix4x4f &base, const std::vector<matrix4x4f> &trans, const RenderData *rd = 0);
 
 		RefCountedPtr<CollMesh> CreateCollisionMesh();
 		RefCountedPtr<CollMesh> GetCollisionMesh() const { return m_collMesh; }
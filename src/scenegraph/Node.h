@@ -49,11 +49,15 @@ namespace SceneGraph {
 		float boundingRadius; //updated by model and passed to submodels
 		unsigned int nodemask;
 
+		//instanced rendering: the instance transforms are relative to this
+		matrix4x4f instanceBase;
+
 		RenderData() :
 			linthrust(),
 			angthrust(),
 			boundingRadius(0.f),
-			nodemask(NODE_SOLID) //draw solids
+			nodemask(NODE_SOLID), //draw solids
+			instanceBase(matrix4x4f::Identity())
 		{
 		}
 	};
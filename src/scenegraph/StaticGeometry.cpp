@@ -9,6 +9,7 @@
 #include "Serializer.h"
 #include "graphics/Graphics.h"
 #include "graphics/Material.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/RenderState.h"
 #include "graphics/Renderer.h"
 #include "utils.h"
@@ -49,10 +50,9 @@ namespace SceneGraph {
 	{
 		PROFILE_SCOPED()
 		SDL_assert(m_renderState);
-		Graphics::Renderer *r = GetRenderer();
-		r->SetTransform(trans);
+		Graphics::RenderQueue &queue = GetRenderer()->GetRenderQueue();
 		for (auto &it : m_meshes)
-			r->DrawBufferIndexed(it.vertexBuffer.Get(), it.indexBuffer.Get(), m_renderState, it.material.Get());
+			queue.DrawBufferIndexed(trans, it.vertexBuffer.Get(), it.indexBuffer.Get(), m_renderState, it.material.Get());
 
 		//DrawBoundingBox(m_boundingBox);
 	}
@@ -74,16 +74,14 @@ namespace SceneGraph {
 		matrix4x4f *pBuffer = ib->Map(Graphics::BUFFER_MAP_WRITE);
 		if (pBuffer) {
 			// Copy the transforms into the buffer
-			for (const matrix4x4f &mt : trans) {
-				(*pBuffer) = mt;
-				++pBuffer;
-			}
+			memcpy(pBuffer, trans.data(), numTrans * sizeof(matrix4x4f));
 			ib->Unmap();
 			ib->SetInstanceCount(numTrans);
 		}
 
-		// we'll set the transformation within the vertex shader so identity the global one
-		r->SetTransform(matrix4x4f::Identity());
+		// the per-instance transformation is applied within the vertex shader,
+		// on top of the base that all of the instances are relative to
+		r->SetTransform(rd->instanceBase);
 
 		if (m_instanceMaterials.empty()) {
 			// process each mesh
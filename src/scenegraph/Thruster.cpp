@@ -7,6 +7,7 @@
 #include "NodeVisitor.h"
 #include "Serializer.h"
 #include "graphics/Material.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/RenderState.h"
 #include "graphics/Renderer.h"
 #include "graphics/TextureBuilder.h"
@@ -108,9 +109,9 @@ namespace SceneGraph {
 			m_glowBuffer.Reset(CreateGlowGeometry(r, m_glowMat.Get()));
 		}
 
-		r->SetTransform(trans);
-		r->DrawBuffer(m_tBuffer.Get(), m_renderState, m_tMat.Get());
-		r->DrawBuffer(m_glowBuffer.Get(), m_renderState, m_glowMat.Get());
+		Graphics::RenderQueue &queue = r->GetRenderQueue();
+		queue.DrawBuffer(trans, m_tBuffer.Get(), m_renderState, m_tMat.Get());
+		queue.DrawBuffer(trans, m_glowBuffer.Get(), m_renderState, m_glowMat.Get());
 	}
 
 	void Thruster::Save(NodeDatabase &db)
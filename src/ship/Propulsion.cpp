@@ -51,6 +51,7 @@ Propulsion::Propulsion()
 	m_fuelStateChange = false;
 	m_linThrusters = vector3d(0, 0, 0);
 	m_angThrusters = vector3d(0, 0, 0);
+	m_aiTimeStep = 0.0f;
 	m_smodel = nullptr;
 	m_dBody = nullptr;
 }
@@ -233,10 +234,15 @@ void Propulsion::Render(Graphics::Renderer *r, const Camera *camera, const vecto
 	if (m_smodel != nullptr) m_smodel->SetThrust(vector3f(GetLinThrusterState()), -vector3f(GetAngThrusterState()));
 }
 
+float Propulsion::GetAITimeStep() const
+{
+	return m_aiTimeStep > 0.0f ? m_aiTimeStep : Pi::game->GetTimeStep();
+}
+
 void Propulsion::AIModelCoordsMatchAngVel(const vector3d &desiredAngVel, double softness)
 {
 	double angAccel = m_angThrust / m_dBody->GetAngularInertia();
-	const double softTimeStep = Pi::game->GetTimeStep() * softness;
+	const double softTimeStep = GetAITimeStep() * softness;
 
 	vector3d angVel = desiredAngVel - m_dBody->GetAngVelocity() * m_dBody->GetOrient();
 	vector3d thrust;
@@ -263,7 +269,7 @@ void Propulsion::AIAccelToModelRelativeVelocity(const vector3d &v)
 {
 	vector3d difVel = v - m_dBody->GetVelocity() * m_dBody->GetOrient(); // required change in velocity
 	vector3d maxThrust = GetThrust(difVel);
-	vector3d maxFrameAccel = maxThrust * (Pi::game->GetTimeStep() / m_dBody->GetMass());
+	vector3d maxFrameAccel = maxThrust * (GetAITimeStep() / m_dBody->GetMass());
 
 	SetLinThrusterState(0, is_zero_exact(maxFrameAccel.x) ? 0.0 : difVel.x / maxFrameAccel.x);
 	SetLinThrusterState(1, is_zero_exact(maxFrameAccel.y) ? 0.0 : difVel.y / maxFrameAccel.y);
@@ -287,7 +293,7 @@ void Propulsion::AIAccelToModelRelativeVelocity(const vector3d &v)
 // sometimes endvel is too low to catch moving objects
 // worked around with half-accel hack in dynamicbody & pi.cpp
 
-double calc_ivel(double dist, double vel, double acc)
+double calc_ivel(double dist, double vel, double acc, double timeStep)
 {
 	bool inv = false;
 	if (dist < 0) {
@@ -297,9 +303,9 @@ double calc_ivel(double dist, double vel, double acc)
 	}
 	double ivel = 0.9 * sqrt(vel * vel + 2.0 * acc * dist); // fudge hardly necessary
 
-	double endvel = ivel - (acc * Pi::game->GetTimeStep());
+	double endvel = ivel - (acc * timeStep);
 	if (endvel <= 0.0)
-		ivel = dist / Pi::game->GetTimeStep(); // last frame discrete correction
+		ivel = dist / timeStep; // last frame discrete correction
 	else
 		ivel = (ivel + endvel) * 0.5; // discrete overshoot correction
 	//	else ivel = endvel + 0.5*acc/PHYSICS_HZ;                  // unknown next timestep discrete overshoot correction
@@ -308,13 +314,13 @@ double calc_ivel(double dist, double vel, double acc)
 }
 
 // version for all-positive values
-double calc_ivel_pos(double dist, double vel, double acc)
+double calc_ivel_pos(double dist, double vel, double acc, double timeStep)
 {
 	double ivel = 0.9 * sqrt(vel * vel + 2.0 * acc * dist); // fudge hardly necessary
 
-	double endvel = ivel - (acc * Pi::game->GetTimeStep());
+	double endvel = ivel - (acc * timeStep);
 	if (endvel <= 0.0)
-		ivel = dist / Pi::game->GetTimeStep(); // last frame discrete correction
+		ivel = dist / timeStep; // last frame discrete correction
 	else
 		ivel = (ivel + endvel) * 0.5; // discrete overshoot correction
 
@@ -334,11 +340,11 @@ bool Propulsion::AIMatchVel(const vector3d &vel)
 bool Propulsion::AIChangeVelBy(const vector3d &diffvel)
 {
 	// counter external forces
-	vector3d extf = m_dBody->GetExternalForce() * (Pi::game->GetTimeStep() / m_dBody->GetMass());
+	vector3d extf = m_dBody->GetExternalForce() * (GetAITimeStep() / m_dBody->GetMass());
 	vector3d diffvel2 = diffvel - extf * m_dBody->GetOrient();
 
 	vector3d maxThrust = GetThrust(diffvel2);
-	vector3d maxFrameAccel = maxThrust * (Pi::game->GetTimeStep() / m_dBody->GetMass());
+	vector3d maxFrameAccel = maxThrust * (GetAITimeStep() / m_dBody->GetMass());
 	vector3d thrust(diffvel2.x / maxFrameAccel.x,
 		diffvel2.y / maxFrameAccel.y,
 		diffvel2.z / maxFrameAccel.z);
@@ -353,7 +359,7 @@ vector3d Propulsion::AIChangeVelDir(const vector3d &reqdiffvel)
 	// get max thrust in desired direction after external force compensation
 	vector3d maxthrust = GetThrust(reqdiffvel);
 	maxthrust += m_dBody->GetExternalForce() * m_dBody->GetOrient();
-	vector3d maxFA = maxthrust * (Pi::game->GetTimeStep() / m_dBody->GetMass());
+	vector3d maxFA = maxthrust * (GetAITimeStep() / m_dBody->GetMass());
 	maxFA.x = fabs(maxFA.x);
 	maxFA.y = fabs(maxFA.y);
 	maxFA.z = fabs(maxFA.z);
@@ -372,7 +378,7 @@ vector3d Propulsion::AIChangeVelDir(const vector3d &reqdiffvel)
 void Propulsion::AIMatchAngVelObjSpace(const vector3d &angvel)
 {
 	double maxAccel = m_angThrust / m_dBody->GetAngularInertia();
-	double invFrameAccel = 1.0 / (maxAccel * Pi::game->GetTimeStep());
+	double invFrameAccel = 1.0 / (maxAccel * GetAITimeStep());
 
 	vector3d diff = angvel - m_dBody->GetAngVelocity() * m_dBody->GetOrient(); // find diff between current & desired angvel
 	SetAngThrusterState(diff * invFrameAccel);
@@ -382,7 +388,7 @@ void Propulsion::AIMatchAngVelObjSpace(const vector3d &angvel)
 double Propulsion::AIFaceUpdir(const vector3d &updir, double av)
 {
 	double maxAccel = m_angThrust / m_dBody->GetAngularInertia(); // should probably be in stats anyway
-	double frameAccel = maxAccel * Pi::game->GetTimeStep();
+	double frameAccel = maxAccel * GetAITimeStep();
 
 	vector3d uphead = updir * m_dBody->GetOrient(); // create desired object-space updir
 	if (uphead.z > 0.99999) return 0; // bail out if facing updir
@@ -392,7 +398,7 @@ double Propulsion::AIFaceUpdir(const vector3d &updir, double av)
 	double ang = 0.0, dav = 0.0;
 	if (uphead.y < 0.99999999) {
 		ang = acos(Clamp(uphead.y, -1.0, 1.0)); // scalar angle from head to curhead
-		double iangvel = av + calc_ivel_pos(ang, 0.0, maxAccel); // ideal angvel at current time
+		double iangvel = av + calc_ivel_pos(ang, 0.0, maxAccel, GetAITimeStep()); // ideal angvel at current time
 
 		dav = uphead.x > 0 ? -iangvel : iangvel;
 	}
@@ -418,7 +424,7 @@ double Propulsion::AIFaceDirection(const vector3d &dir, double av)
 	double ang = 0.0;
 	if (head.z > -0.99999999) {
 		ang = acos(Clamp(-head.z, -1.0, 1.0)); // scalar angle from head to curhead
-		double iangvel = av + calc_ivel_pos(ang, 0.0, maxAccel); // ideal angvel at current time
+		double iangvel = av + calc_ivel_pos(ang, 0.0, maxAccel, GetAITimeStep()); // ideal angvel at current time
 
 		// Normalize (head.x, head.y) to give desired angvel direction
 		if (head.z > 0.999999) head.x = 1.0;
@@ -427,7 +433,7 @@ double Propulsion::AIFaceDirection(const vector3d &dir, double av)
 		dav.y = -head.x * head2dnorm * iangvel;
 	}
 	const vector3d cav = m_dBody->GetAngVelocity() * m_dBody->GetOrient(); // current obj-rel angvel
-	const double frameAccel = maxAccel * Pi::game->GetTimeStep();
+	const double frameAccel = maxAccel * GetAITimeStep();
 	vector3d diff = is_zero_exact(frameAccel) ? vector3d(0.0) : (dav - cav) / frameAccel; // find diff between current & desired angvel
 
 	// If the player is pressing a roll key, don't override roll.
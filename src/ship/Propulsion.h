@@ -115,8 +115,13 @@ public:
 	double AIFaceUpdir(const vector3d &updir, double av = 0);
 	double AIFaceDirection(const vector3d &dir, double av = 0);
 	vector3d AIGetLeadDir(const Body *target, const vector3d &targaccel, double projspeed);
+	// Time the AI functions above plan over, for an AI command that covers
+	// several physics ticks. 0 means the game timestep
+	inline void SetAITimeStep(float timeStep) { m_aiTimeStep = timeStep; }
 
 private:
+	float GetAITimeStep() const;
+
 	// Thrust and thrusters
 	float m_linThrust[THRUSTER_MAX];
 	float m_angThrust;
@@ -132,6 +137,8 @@ private:
 	double m_effectiveExhaustVelocity;
 	bool m_fuelStateChange;
 
+	float m_aiTimeStep;
+
 	const DynamicBody *m_dBody;
 	SceneGraph::Model *m_smodel;
 };